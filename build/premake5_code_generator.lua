@@ -4,6 +4,33 @@ rive = '../rive-runtime'
 -- dofile(path.join(path.getabsolute(rive) .. '/build', 'rive_build_config.lua'))
 dofile(path.join(path.getabsolute(rive) .. '/premake5_v2.lua'))
 
+-- Extraction and rendering, for the command line tool and for hosts that
+-- generate code in process through the C API in rive_codegen.h
+project('rive_codegen')
+do
+    kind('StaticLib')
+    language('C++')
+    cppdialect('C++17')
+
+    includedirs({
+        '../include',
+        rive .. '/include',
+        '../external/',
+    })
+
+    files({
+        '../src/**.cpp',
+        rive .. '/utils/no_op_factory.cpp',
+    })
+    removefiles({ '../src/main.cpp' })
+
+    buildoptions({ '-Wall', '-fexceptions', '-fno-rtti' })
+
+    filter "action:vs*"
+        buildoptions { "/EHsc" }
+    filter {}
+end
+
 project('rive_code_generator')
 do
     kind('ConsoleApp')
@@ -16,16 +43,38 @@ do
         '../external/',
     })
 
-    links({ 'rive' })
+    links({ 'rive_codegen', 'rive' })
+    dependson({ 'template_codegen' })
 
     files({
-        '../src/**.cpp',
-        rive .. '/utils/no_op_factory.cpp',
+        '../src/main.cpp',
+        '../include/default_template.h',
     })
 
+    -- The built-in templates are compiled into C++ render functions
+    filter({ 'files:../include/default_template.h' })
+    do
+        buildmessage('Compiling built-in templates')
+        buildcommands({
+            '"%{cfg.targetdir}/template_codegen" "%{cfg.objdir}/builtin_templates.cpp"',
+        })
+        buildinputs({
+            '%{cfg.targetdir}/template_codegen%{cfg.buildtarget.extension}',
+        })
+        buildoutputs({ '%{cfg.objdir}/builtin_templates.cpp' })
+        compilebuildoutputs('on')
+    end
+    filter({})
+
     -- buildoptions({ '-Wall', '-fno-exceptions', '-fno-rtti' })
     buildoptions({ '-Wall', '-fexceptions', '-fno-rtti' })
 
+    filter({ 'system:linux' })
+    do
+        links({ 'pthread' })
+    end
+    filter({})
+
     -- filter({ 'system:macosx' })
     -- do
     --     links({
@@ -37,4 +86,136 @@ do
     filter "action:vs*"
         buildoptions { "/EHsc" }
     filter {}
-end
\ No newline at end of file
+end
+
+project('template_codegen')
+do
+    kind('ConsoleApp')
+    language('C++')
+    cppdialect('C++17')
+
+    includedirs({
+        '../include',
+        '../external/',
+    })
+
+    files({
+        '../tools/template_codegen.cpp',
+        '../src/template_schema.cpp',
+    })
+
+    buildoptions({ '-Wall', '-fexceptions', '-fno-rtti' })
+
+    filter "action:vs*"
+        buildoptions { "/EHsc" }
+    filter {}
+end
+
+project('string_escape_test')
+do
+    kind('ConsoleApp')
+    language('C++')
+    cppdialect('C++17')
+
+    includedirs({
+        '../include',
+        '../external/',
+    })
+
+    files({
+        '../test/string_escape_test.cpp',
+        '../src/string_escape.cpp',
+    })
+
+    buildoptions({ '-Wall', '-fexceptions', '-fno-rtti' })
+
+    filter "action:vs*"
+        buildoptions { "/EHsc" }
+    filter {}
+end
+
+project('template_compiler_test')
+do
+    kind('ConsoleApp')
+    language('C++')
+    cppdialect('C++17')
+
+    includedirs({
+        '../include',
+        '../external/',
+    })
+
+    files({
+        '../test/template_compiler_test.cpp',
+        '../src/template_compiler.cpp',
+        '../src/template_schema.cpp',
+        '../src/template_data.cpp',
+        '../src/extraction_stages.cpp',
+        '../src/naming.cpp',
+        '../src/string_escape.cpp',
+    })
+
+    buildoptions({ '-Wall', '-fexceptions', '-fno-rtti' })
+
+    filter "action:vs*"
+        buildoptions { "/EHsc" }
+    filter {}
+end
+
+project('allocation_test')
+do
+    kind('ConsoleApp')
+    language('C++')
+    cppdialect('C++17')
+
+    includedirs({
+        '../include',
+        rive .. '/include',
+        '../external/',
+    })
+
+    links({ 'rive' })
+
+    files({
+        '../test/allocation_test.cpp',
+        '../src/rive_extractor.cpp',
+        '../src/parallel_for.cpp',
+        '../src/template_data.cpp',
+        '../src/structure_interner.cpp',
+        '../src/extraction_stages.cpp',
+        '../src/naming.cpp',
+        '../src/string_escape.cpp',
+        rive .. '/utils/no_op_factory.cpp',
+    })
+
+    buildoptions({ '-Wall', '-fexceptions', '-fno-rtti' })
+
+    filter({ 'system:linux' })
+    do
+        links({ 'pthread' })
+    end
+    filter({})
+
+    filter "action:vs*"
+        buildoptions { "/EHsc" }
+    filter {}
+end
+
+project('codegen_api_test')
+do
+    kind('ConsoleApp')
+    -- The test is C, but the library it links is C++
+    language('C++')
+
+    includedirs({ '../include' })
+
+    links({ 'rive_codegen', 'rive' })
+
+    files({ '../test/codegen_api_test.c' })
+
+    filter({ 'system:linux' })
+    do
+        links({ 'pthread' })
+    end
+    filter({})
+end
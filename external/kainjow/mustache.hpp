@@ -221,6 +221,10 @@ namespace kainjow
             {
                 str_.reset(new string_type(string));
             }
+            basic_data(string_type &&string) : type_{type::string}
+            {
+                str_.reset(new string_type(std::move(string)));
+            }
             basic_data(const typename string_type::value_type *string) : type_{type::string}
             {
                 str_.reset(new string_type(string));
@@ -233,6 +237,10 @@ namespace kainjow
             {
                 list_.reset(new basic_list<string_type>(l));
             }
+            basic_data(basic_list<string_type> &&l) : type_{type::list}
+            {
+                list_.reset(new basic_list<string_type>(std::move(l)));
+            }
             basic_data(type t) : type_{t}
             {
                 switch (type_)
@@ -308,7 +316,7 @@ namespace kainjow
             }
 
             // Move
-            basic_data(basic_data &&dat) : type_{dat.type_}
+            basic_data(basic_data &&dat) noexcept : type_{dat.type_}
             {
                 if (dat.obj_)
                 {
@@ -332,7 +340,7 @@ namespace kainjow
                 }
                 dat.type_ = type::invalid;
             }
-            basic_data &operator=(basic_data &&dat)
+            basic_data &operator=(basic_data &&dat) noexcept
             {
                 if (this != &dat)
                 {
@@ -430,6 +438,14 @@ namespace kainjow
                     obj_->insert(std::pair<string_type, basic_data>{name, var});
                 }
             }
+            void set(string_type &&name, basic_data &&var)
+            {
+                if (is_object())
+                {
+                    obj_->erase(name);
+                    obj_->emplace(std::move(name), std::move(var));
+                }
+            }
             const basic_data *get(const string_type &name) const
             {
                 if (!is_object())
@@ -452,6 +468,13 @@ namespace kainjow
                     list_->push_back(var);
                 }
             }
+            void push_back(basic_data &&var)
+            {
+                if (is_list())
+                {
+                    list_->push_back(std::move(var));
+                }
+            }
             const basic_list<string_type> &list_value() const
             {
                 return *list_;
@@ -787,6 +810,22 @@ namespace kainjow
             }
         };
 
+        // Told what a template does as it renders, to profile it
+        template <typename string_type>
+        class basic_render_observer
+        {
+        public:
+            virtual ~basic_render_observer() = default;
+            // Around the rendering of each text and tag component, which for
+            // a section includes its contents
+            virtual void enter(const component<string_type> &comp) = 0;
+            virtual void leave(const component<string_type> &comp) = 0;
+            // Each time the contents of the section being rendered render
+            virtual void section_iteration() = 0;
+            // Output added to the current line
+            virtual void emitted(std::size_t size) = 0;
+        };
+
         template <typename string_type>
         class parser
         {
@@ -1093,6 +1132,12 @@ namespace kainjow
                 escape_ = escape_fn;
             }
 
+            // Not owned, and null to render without observing
+            void set_render_observer(basic_render_observer<string_type> *observer)
+            {
+                observer_ = observer;
+            }
+
             template <typename stream_type>
             stream_type &render(const basic_data<string_type> &data, stream_type &stream)
             {
@@ -1183,6 +1228,10 @@ namespace kainjow
                     if (comp)
                     {
                         handler(comp->text);
+                        if (observer_)
+                        {
+                            observer_->emitted(comp->text.size());
+                        }
                     }
                 }
                 ctx.line_buffer.clear();
@@ -1191,9 +1240,25 @@ namespace kainjow
             void render_result(context_internal<string_type> &ctx, const string_type &text) const
             {
                 ctx.line_buffer.data.append(text);
+                if (observer_)
+                {
+                    observer_->emitted(text.size());
+                }
             }
 
             typename component<string_type>::walk_control render_component(const render_handler &handler, context_internal<string_type> &ctx, component<string_type> &comp)
+            {
+                if (!observer_)
+                {
+                    return render_component_unobserved(handler, ctx, comp);
+                }
+                observer_->enter(comp);
+                const auto control = render_component_unobserved(handler, ctx, comp);
+                observer_->leave(comp);
+                return control;
+            }
+
+            typename component<string_type>::walk_control render_component_unobserved(const render_handler &handler, context_internal<string_type> &ctx, component<string_type> &comp)
             {
                 if (comp.is_text())
                 {
@@ -1378,6 +1443,10 @@ namespace kainjow
                 {
                     for (const auto &item : var->list_value())
                     {
+                        if (observer_)
+                        {
+                            observer_->section_iteration();
+                        }
                         // account for the section begin tag
                         ctx.line_buffer.contained_section_tag = true;
 
@@ -1390,6 +1459,10 @@ namespace kainjow
                 }
                 else if (var)
                 {
+                    if (observer_)
+                    {
+                        observer_->section_iteration();
+                    }
                     // account for the section begin tag
                     ctx.line_buffer.contained_section_tag = true;
 
@@ -1401,6 +1474,10 @@ namespace kainjow
                 }
                 else
                 {
+                    if (observer_)
+                    {
+                        observer_->section_iteration();
+                    }
                     // account for the section begin tag
                     ctx.line_buffer.contained_section_tag = true;
 
@@ -1415,6 +1492,7 @@ namespace kainjow
             string_type error_message_;
             component<string_type> root_component_;
             escape_handler escape_;
+            basic_render_observer<string_type> *observer_ = nullptr;
         };
 
         using mustache = basic_mustache<std::string>;
@@ -1426,6 +1504,8 @@ namespace kainjow
         using lambda = basic_lambda<mustache::string_type>;
         using lambda2 = basic_lambda2<mustache::string_type>;
         using lambda_t = basic_lambda_t<mustache::string_type>;
+        using component_t = component<mustache::string_type>;
+        using render_observer = basic_render_observer<mustache::string_type>;
 
         using mustachew = basic_mustache<std::wstring>;
         using dataw = basic_data<mustachew::string_type>;
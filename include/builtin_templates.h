@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "rive_file_data.h"
+
+// The built-in templates of default_template.h, compiled into C++ at build
+// time by tools/template_codegen.cpp. Each appends to `output` exactly what
+// rendering the template source would.
+
+void renderDefaultDartTemplate(const std::vector<RiveFileData>& files,
+                               const std::string& generatedFileName,
+                               std::string& output);
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "extraction_stages.h"
+#include "rive_file_data.h"
+
+// Generates a self-contained C++17 header exposing the names in each Rive
+// file as constexpr constants, together with the index of every artboard,
+// animation, state machine and input and a compile-time perfect-hash table
+// per list mapping a name back to its index. Returns nullopt, after
+// reporting the error, if a list's table can't be built.
+std::optional<std::string> generateCppHeader(
+    const std::vector<RiveFileData>& riveFiles,
+    const std::string& generatedFileName);
+
+// The parts of the files generateCppHeader uses
+ExtractionStages cppHeaderStages();
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// The parts of a Rive file that are extracted. Everything but the file names
+// costs something to extract, and the artboard parts need an instance of
+// every artboard, so outputs only ask for the parts they use.
+struct ExtractionStages
+{
+    bool assets = false;
+    bool enums = false;
+    bool viewModels = false;
+    // Artboard names. Implied by every other artboard stage.
+    bool artboards = false;
+    bool animations = false;
+    bool stateMachines = false;
+    bool textValueRuns = false;
+    bool nestedTextValueRuns = false;
+    // The graph of named nested artboards, an alternative to the paths of
+    // nestedTextValueRuns that doesn't grow with the number of paths
+    bool nestedArtboards = false;
+
+    static ExtractionStages all();
+};
+
+// The names used by --only, matching the template lists they fill:
+// "assets", "enums", "view_models", "artboards", "animations",
+// "state_machines", "text_value_runs", "nested_text_value_runs" and
+// "nested_artboards"
+const std::vector<std::string>& extractionStageNames();
+
+// Stages from names in extractionStageNames()
+ExtractionStages stagesFromNames(const std::vector<std::string>& names);
+
+// Stages as bits, bit i being the stage named extractionStageNames()[i]
+uint32_t stagesToBits(const ExtractionStages& stages);
+ExtractionStages stagesFromBits(uint32_t bits);
+
+// The names the tags of `source` look up, with dotted names split into
+// their parts. Returns nullopt if the template doesn't parse.
+std::optional<std::unordered_set<std::string>> templateTagNames(
+    const std::string& source);
+
+// The stages whose data `source` references, found from the names of its
+// tags. {{is_shared}} and {{#shared_artboards}} need every artboard stage,
+// since artboards are only shared when everything extracted from them is
+// equal. Templates that don't parse get every stage, so that the render
+// reports the error.
+ExtractionStages stagesForTemplate(const std::string& source);
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "extraction_stages.h"
+#include "rive_file_data.h"
+#include "structure_interner.h"
+
+// Limits on each worker process of --isolate
+struct IsolationLimits
+{
+    // How long a worker may spend on one file before it's killed
+    std::chrono::seconds timeout{60};
+    // The address space of a worker in bytes, or 0 for no limit
+    uint64_t memoryLimit = 0;
+};
+
+// Extracts `riveFiles` in a pool of forked worker processes, one per core,
+// which send each file's data back over a pipe as partial results. A file
+// that crashes its worker, runs past the timeout or out of memory is
+// reported and skipped, and the worker is replaced, so one bad file doesn't
+// stop the rest. onFile is called with the index and data of each file that
+// could be read, in order. Structures are interned with `interner`, or only
+// within each file if it's null. Returns false if the workers can't be
+// started, with the error already printed.
+bool extractRiveFilesIsolated(
+    const std::vector<std::string>& riveFiles,
+    const ExtractionStages& stages,
+    const IsolationLimits& limits,
+    StructureInterner* interner,
+    const std::function<void(size_t, RiveFileData&&)>& onFile);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+#include "rive_file_data.h"
+
+// Streams the JSON representation of Rive files, with the same layout as
+// templates/json_template.mustache, without going through Mustache. Each
+// file is serialized as soon as it is added and output is flushed in fixed
+// size chunks, so memory use doesn't grow with the number of files.
+class JsonGenerator
+{
+public:
+    explicit JsonGenerator(std::ostream& output);
+
+    void addFile(const RiveFileData& riveFile);
+
+    // Closes the document and flushes the remaining output
+    void finish();
+
+private:
+    void write(const char* str) { m_buffer += str; }
+    void write(const std::string& str) { m_buffer += str; }
+    void writeString(const std::string& str);
+    void writeField(const char* indent,
+                    const char* key,
+                    const std::string& value,
+                    bool last = false);
+    void beginItem(bool& first);
+    void endList(bool first, const char* indent);
+    void flushIfFull();
+
+    void writeArtboard(const ArtboardData& artboard);
+
+    std::ostream& m_output;
+    std::string m_buffer;
+    bool m_firstFile = true;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <unordered_set>
+
+enum class CaseStyle
+{
+    Camel,
+    Pascal,
+    Snake,
+    Kebab,
+};
+
+std::string toCamelCase(const std::string& str);
+std::string toPascalCase(const std::string& str);
+std::string toSnakeCase(const std::string& str);
+std::string toKebabCase(const std::string& str);
+
+// Returns `base`, or `base` with a "U<n>" suffix if it is already in
+// `usedNames`, and records the returned name as used
+std::string makeUnique(const std::string& base,
+                       std::unordered_set<std::string>& usedNames);
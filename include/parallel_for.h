@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Calls work(i) for every i below count, on a pool with a thread per core.
+// Calls can nest: threads with nothing left to do take indices from any loop
+// still running, so a loop inside one item of another, such as the
+// artboards of one large file among several, is spread over the idle cores.
+// If work throws, the indices not yet started are skipped and the first
+// exception is rethrown once the ones already running have finished.
+void parallelFor(size_t count, const std::function<void(size_t)>& work);
+
+// Makes every later parallelFor run on the calling thread, for processes that
+// are already one of a pool running a process per core
+void runParallelForSerially();
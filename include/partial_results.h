@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "extraction_stages.h"
+#include "rive_file_data.h"
+#include "structure_interner.h"
+
+// The files one --shard run extracted, which --merge combines with the
+// other shards' to render the output
+struct PartialResults
+{
+    uint32_t shardIndex = 0;
+    uint32_t shardCount = 1;
+    // What was extracted from each file
+    ExtractionStages stages;
+
+    struct File
+    {
+        // Where the file was found, relative to the input directory. Orders
+        // the files when merging, as it does in a single run.
+        std::string relativePath;
+        RiveFileData data;
+    };
+    std::vector<File> files;
+};
+
+// The shard a file belongs to out of `shardCount`, by a hash of its
+// relative path that is the same on every machine
+uint32_t shardOf(const std::string& relativePath, uint32_t shardCount);
+
+// A compact binary encoding of `partial`, in which each distinct structure
+// is written once however many files use it
+std::string serializePartialResults(const PartialResults& partial);
+
+// Decodes partial results read from `path`, interning their structures with
+// `interner` so that equal structures from different shards are shared as
+// they are in a single run. Returns nullopt if the data isn't partial
+// results from this version, with the error already printed.
+std::optional<PartialResults> deserializePartialResults(
+    const std::string& bytes,
+    const std::string& path,
+    StructureInterner& interner);
@@ -0,0 +1,132 @@
+#pragma once
+
+// C API of the rive_codegen library, for generating code in process rather
+// than running rive_code_generator. Rive files are extracted from memory
+// into handles that can be rendered any number of times, with any number of
+// templates, so a host can keep them between regenerations and only
+// re-extract the files that changed.
+//
+// Strings are UTF-8 and aren't NUL terminated unless noted. Handles can be
+// used from several threads, but each handle from one thread at a time.
+//
+// The first file opened starts a pool of detached threads, one per core,
+// which the artboards of every later file are extracted on. The pool is
+// shared by the whole process and lives until it exits.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(RIVE_CODEGEN_SHARED) && defined(_WIN32)
+#if defined(RIVE_CODEGEN_BUILD)
+#define RIVE_CODEGEN_API __declspec(dllexport)
+#else
+#define RIVE_CODEGEN_API __declspec(dllimport)
+#endif
+#elif defined(RIVE_CODEGEN_SHARED)
+#define RIVE_CODEGEN_API __attribute__((visibility("default")))
+#else
+#define RIVE_CODEGEN_API
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Incremented when the API changes incompatibly
+#define RIVE_CODEGEN_API_VERSION 1
+
+typedef enum rive_codegen_status
+{
+    RIVE_CODEGEN_OK = 0,
+    // A NULL handle or output pointer, or an unknown stage
+    RIVE_CODEGEN_INVALID_ARGUMENT = 1,
+    // The Rive file is empty or doesn't parse
+    RIVE_CODEGEN_INVALID_FILE = 2,
+    // The template doesn't parse
+    RIVE_CODEGEN_INVALID_TEMPLATE = 3,
+    // The output didn't fit in the buffer, and nothing was written
+    RIVE_CODEGEN_BUFFER_TOO_SMALL = 4,
+    // The library failed unexpectedly, such as by running out of memory
+    RIVE_CODEGEN_INTERNAL_ERROR = 5,
+} rive_codegen_status;
+
+// The parts of a Rive file to extract, like --only. The lists of the parts
+// that aren't extracted are empty.
+enum
+{
+    RIVE_CODEGEN_STAGE_ASSETS = 1 << 0,
+    RIVE_CODEGEN_STAGE_ENUMS = 1 << 1,
+    RIVE_CODEGEN_STAGE_VIEW_MODELS = 1 << 2,
+    RIVE_CODEGEN_STAGE_ARTBOARDS = 1 << 3,
+    RIVE_CODEGEN_STAGE_ANIMATIONS = 1 << 4,
+    RIVE_CODEGEN_STAGE_STATE_MACHINES = 1 << 5,
+    RIVE_CODEGEN_STAGE_TEXT_VALUE_RUNS = 1 << 6,
+    RIVE_CODEGEN_STAGE_NESTED_TEXT_VALUE_RUNS = 1 << 7,
+    RIVE_CODEGEN_STAGE_NESTED_ARTBOARDS = 1 << 8,
+    RIVE_CODEGEN_STAGE_ALL = (1 << 9) - 1,
+};
+
+// Shares the structures of the files extracted with it: equal artboards,
+// enums and view models are kept once. Structures are kept until the
+// context is destroyed, so long-lived hosts should replace it now and then.
+typedef struct rive_codegen_context rive_codegen_context;
+
+// The extracted data of one Rive file. Doesn't reference the bytes it was
+// extracted from, and can outlive its context.
+typedef struct rive_codegen_file rive_codegen_file;
+
+// A Mustache template, parsed once to be rendered many times
+typedef struct rive_codegen_template rive_codegen_template;
+
+// RIVE_CODEGEN_API_VERSION of the library, which hosts that load it
+// dynamically should check
+RIVE_CODEGEN_API uint32_t rive_codegen_api_version(void);
+
+// The reason the last failed call on this thread failed, as a NUL
+// terminated string. Empty if no call has failed.
+RIVE_CODEGEN_API const char* rive_codegen_last_error(void);
+
+RIVE_CODEGEN_API rive_codegen_context* rive_codegen_context_create(void);
+RIVE_CODEGEN_API void rive_codegen_context_destroy(
+    rive_codegen_context* context);
+
+// Extracts the `stages` of the Rive file in `bytes`, which the caller can
+// free as soon as this returns. The stem of `name`, such as "rating" for
+// "icons/rating.riv", names the file in the output.
+RIVE_CODEGEN_API rive_codegen_status
+rive_codegen_file_open(rive_codegen_context* context,
+                       const char* name,
+                       size_t name_size,
+                       const uint8_t* bytes,
+                       size_t size,
+                       uint32_t stages,
+                       rive_codegen_file** file);
+RIVE_CODEGEN_API void rive_codegen_file_close(rive_codegen_file* file);
+
+RIVE_CODEGEN_API rive_codegen_status
+rive_codegen_template_parse(const char* source,
+                            size_t size,
+                            rive_codegen_template** tmpl);
+RIVE_CODEGEN_API void rive_codegen_template_destroy(
+    rive_codegen_template* tmpl);
+
+// The stages the template uses, which is all that files rendered with it need
+RIVE_CODEGEN_API uint32_t
+rive_codegen_template_stages(const rive_codegen_template* tmpl);
+
+// Renders `tmpl` for `files`, in order, into `buffer`. `*size` is set to the
+// size of the whole output; if it's more than `capacity`, nothing is written
+// and RIVE_CODEGEN_BUFFER_TOO_SMALL is returned, so the call can be repeated
+// with a large enough buffer.
+RIVE_CODEGEN_API rive_codegen_status
+rive_codegen_render(const rive_codegen_template* tmpl,
+                    rive_codegen_file* const* files,
+                    size_t file_count,
+                    char* buffer,
+                    size_t capacity,
+                    size_t* size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "rive_file_data.h"
+
+// A difference between two versions of Rive files
+struct RiveChange
+{
+    enum class Type
+    {
+        Added,
+        Removed,
+        Changed,
+    };
+
+    Type type;
+    // What changed: "file", "artboard", "animation", "state_machine",
+    // "input", "text_run", "nested_text_run", "asset", "enum",
+    // "enum_value", "view_model" or "property"
+    std::string kind;
+    // Names from the file down to what changed
+    std::vector<std::string> path;
+    // For Changed, which field changed and its values on each side
+    std::string field;
+    std::string before;
+    std::string after;
+};
+
+// Compares two versions of one file. Elements are matched by name, with
+// repeated names matched in order, so this is linear in the size of the
+// files. Interned artboards, enums and view models that are the same object
+// on both sides are skipped without being looked into.
+std::vector<RiveChange> diffRiveFile(const RiveFileData& before,
+                                     const RiveFileData& after);
+
+// Compares two sets of files, matching the files by name
+std::vector<RiveChange> diffRiveFiles(const std::vector<RiveFileData>& before,
+                                      const std::vector<RiveFileData>& after);
+
+// Writes each change as a JSON object on a line of its own, such as
+// {"change":"changed","kind":"input","path":["rating","Complete",
+// "State Machine 1","Rating"],"field":"default","before":"0","after":"1"}
+void writeChanges(std::ostream& output, const std::vector<RiveChange>& changes);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "extraction_stages.h"
+#include "rive_file_data.h"
+#include "structure_interner.h"
+
+// Reads the parts of a Rive file in `stages`, leaving the rest empty.
+// Returns nullopt if the file can't be read, with the error already printed.
+std::optional<RiveFileData> processRiveFile(const std::string& riveFilePath,
+                                            StructureInterner& interner,
+                                            const ExtractionStages& stages);
+
+// processRiveFile() for a file already in memory, such as one read from stdin
+// or an archive. `riveFilePath` names the file in errors, and its stem names
+// it in the output.
+std::optional<RiveFileData> processRiveBytes(const std::string& riveFilePath,
+                                             const uint8_t* bytes,
+                                             size_t size,
+                                             StructureInterner& interner,
+                                             const ExtractionStages& stages);
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Data extracted from a Rive file, independent of the output format
+
+struct InputInfo
+{
+    std::string name;
+    std::string type;
+    std::string defaultValue;
+};
+
+struct TextValueRunInfo
+{
+    std::string name;
+    std::string defaultValue;
+};
+
+struct NestedTextValueRunInfo
+{
+    std::string name;
+    std::string path;
+};
+
+// A named artboard nested in another, which is an edge of the graph of the
+// file's artboards that the nested text value runs are paths through
+struct NestedArtboardInfo
+{
+    // The name paths through it are made of
+    std::string name;
+    // Name and index in the file of the artboard it's an instance of
+    std::string artboardName;
+    size_t artboardIndex = 0;
+};
+
+struct AssetInfo
+{
+    std::string name;
+    std::string type;
+    std::string fileExtension;
+    std::string assetId;
+    std::string cdnUuid;
+    std::string cdnBaseUrl;
+};
+
+struct EnumValueInfo
+{
+    std::string key;
+};
+
+struct EnumInfo
+{
+    std::string name;
+    std::vector<EnumValueInfo> values;
+};
+
+struct PropertyInfo
+{
+    std::string name;
+    std::string type;
+    std::string backingName;
+};
+
+struct ViewModelInfo
+{
+    std::string name;
+    std::vector<PropertyInfo> properties;
+};
+
+struct ArtboardData
+{
+    std::string artboardName;
+    std::string artboardPascalCase;
+    std::string artboardCameCase;
+    std::string artboardSnakeCase;
+    std::string artboardKebabCase;
+    std::vector<std::string> animations;
+    std::vector<std::pair<std::string, std::vector<InputInfo>>> stateMachines;
+    std::vector<TextValueRunInfo> textValueRuns;
+    std::vector<NestedTextValueRunInfo> nestedTextValueRuns;
+    std::vector<NestedArtboardInfo> nestedArtboards;
+};
+
+// Artboards, enums and view models are interned (see structure_interner.h),
+// so files built from the same components point at the same objects
+struct RiveFileData
+{
+    std::string rivName;
+    std::string rivPascalCase;
+    std::string rivCameCase;
+    std::string riveSnakeCase;
+    std::string rivKebabCase;
+    // FNV-1a of the file's bytes, which generated code can compare with the
+    // file it loads to check that the indices it was generated with hold
+    uint64_t fingerprint = 0;
+    std::vector<std::shared_ptr<const ArtboardData>> artboards;
+    std::vector<AssetInfo> assets;
+    std::vector<std::shared_ptr<const EnumInfo>> enums;
+    std::vector<std::shared_ptr<const ViewModelInfo>> viewmodels;
+};
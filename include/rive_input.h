@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <optional>
+#include <string>
+#include <vector>
+
+// A Rive file read into memory, from stdin or a tar archive
+struct RiveInput
+{
+    // Names the file in errors, and its stem names the file in the output
+    std::string path;
+    std::vector<uint8_t> bytes;
+};
+
+// "-i -" reads a single Rive file from stdin
+bool isStdinPath(const std::string& path);
+
+// Tar archives are recognized by their ".tar" extension
+bool isTarPath(const std::string& path);
+
+// Reads all of stdin as one Rive file named "stdin". Returns nullopt if it
+// can't be read, with the error already printed.
+std::optional<RiveInput> readStdin();
+
+// Reads the .riv entries of the tar archive in `stream` in archive order,
+// passing each one to `onEntry` as soon as its contents have been read, so
+// that only one entry is held in memory at a time. Other entries are
+// skipped. Entries are named "<archivePath>/<entry name>". Returns false if
+// the archive is malformed, with the error already printed.
+bool readTarArchive(std::istream& stream,
+                    const std::string& archivePath,
+                    const std::function<void(RiveInput&&)>& onEntry);
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+
+// Escaping used for generated output. Each escaper scans 16 (SSE2) or 32
+// (AVX2) bytes at a time for characters that need escaping and copies the
+// runs in between in bulk, falling back to a scalar scan elsewhere.
+
+// Escapes newlines, tabs, quotes, backslashes and non-printable characters
+// (as \uXXXX) for use in string literals
+std::string sanitizeString(const std::string& input);
+
+// Escapes &, <, >, " and ' as HTML entities, matching Mustache's default
+// escaping of {{variables}}
+std::string htmlEscape(const std::string& input);
+
+// Appends `input` to `output` escaped like htmlEscape
+void appendHtmlEscaped(std::string& output, const std::string& input);
+
+// Appends `input` to `output` escaped for use in a JSON string
+void appendJsonEscaped(std::string& output, const std::string& input);
+
+enum class EscapeKernel
+{
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+// The kernel in use, which defaults to the fastest one the CPU supports
+EscapeKernel escapeKernel();
+
+// Forces a kernel, for tests and benchmarks. Returns false, leaving the
+// current kernel in place, if the CPU or build doesn't support it.
+bool setEscapeKernel(EscapeKernel kernel);
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "rive_file_data.h"
+
+// Keeps one copy of each distinct artboard, enum and view model. Interning
+// a structure equal to one seen before returns the existing copy, so files
+// made from the same design-system components share their structures.
+// Files can be interned from several threads at once.
+class StructureInterner
+{
+public:
+    std::shared_ptr<const ArtboardData> intern(ArtboardData&& artboard);
+    std::shared_ptr<const EnumInfo> intern(EnumInfo&& enumInfo);
+    std::shared_ptr<const ViewModelInfo> intern(ViewModelInfo&& viewModel);
+
+private:
+    // Structures by content hash, with the rare collisions side by side
+    template <typename T>
+    using Table =
+        std::unordered_map<uint64_t, std::vector<std::shared_ptr<const T>>>;
+
+    std::mutex m_mutex;
+    Table<ArtboardData> m_artboards;
+    Table<EnumInfo> m_enums;
+    Table<ViewModelInfo> m_viewModels;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "kainjow/mustache.hpp"
+#include "template_schema.h"
+
+// Renders Mustache templates exactly like kainjow::mustache, but from a flat
+// instruction list. Every name in the template is resolved once, when it's
+// compiled, against the schema of the template data (template_schema.h): a
+// tag reads a fixed slot of a fixed level of a plain stack instead of
+// searching each context level's map by name. A record's slots are looked
+// up as a section pushes it.
+class CompiledTemplate
+{
+public:
+    // Appends a value escaped for {{variables}} to the output
+    using EscapeFunction =
+        std::function<void(std::string& output, const std::string& value)>;
+
+    // Compiles `source` for data of the schema type `rootType`. Returns
+    // nullopt for what the compiler doesn't handle, which kainjow should
+    // render instead: invalid templates, partials and sections over {{.}}.
+    static std::optional<CompiledTemplate> compile(
+        const std::string& source,
+        const std::string& rootType = "Root");
+
+    // Appends the template rendered for `data` to `output`. Returns false,
+    // leaving `output` as it was, if a record doesn't have the names the
+    // template reads from it as the schema says, or has a name the schema
+    // says it doesn't, which kainjow should render instead.
+    bool render(const kainjow::mustache::data& data,
+                const EscapeFunction& escape,
+                std::string& output) const;
+
+private:
+    friend class TemplateCompiler;
+
+    enum class Op : uint8_t
+    {
+        Text,
+        Newline,
+        Variable,
+        UnescapedVariable,
+        SectionBegin,
+        SectionEnd,
+        InvertedBegin,
+        InvertedEnd,
+        // A section tag that doesn't push anything, such as an inverted
+        // section over a name no level defines
+        SectionTag,
+    };
+
+    static constexpr uint32_t NoSlot = UINT32_MAX;
+
+    struct Instruction
+    {
+        Op op;
+        // Stack level the name resolved at, the layout of the records there
+        // and the name's slot in it, or NoSlot for the item at that level
+        // itself ({{.}})
+        uint32_t level = 0;
+        int layout = -1;
+        uint32_t slot = NoSlot;
+        // Stack level a section pushes to
+        uint32_t depth = 0;
+        // Index of the matching section begin or end
+        uint32_t jump = 0;
+        // Range of m_text for Text and Newline
+        uint32_t textOffset = 0;
+        uint32_t textSize = 0;
+    };
+
+    // A name the template reads from the records of a layout
+    struct Slot
+    {
+        // The name, split at dots
+        std::vector<std::string> path;
+        TemplateFieldKind kind = TemplateFieldKind::String;
+        // For Object and List slots, the layout of the records they hold
+        int layout = -1;
+    };
+
+    // The slots of a schema type that the template reads, and the names it
+    // looks past the records for, which they mustn't have
+    struct Layout
+    {
+        std::vector<Slot> slots;
+        std::vector<std::vector<std::string>> absent;
+    };
+
+    std::vector<Instruction> m_instructions;
+    std::string m_text;
+    // m_layouts[0] is the layout of the root data
+    std::vector<Layout> m_layouts;
+    uint32_t m_maxDepth = 1;
+};
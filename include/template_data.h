@@ -0,0 +1,203 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "kainjow/mustache.hpp"
+#include "rive_file_data.h"
+
+// Converts extracted Rive files into the variables exposed to Mustache
+// templates
+
+// The name of the generated file, without an extension
+extern const std::string generatedFileName;
+
+// {{riv_fingerprint}}: the file's fingerprint as 16 hex digits
+std::string fingerprintString(uint64_t fingerprint);
+
+// The case variants of one kind of name, `<kind>_camel_case` and so on, that
+// template data includes
+struct CaseVariants
+{
+    bool camel = true;
+    bool pascal = true;
+    bool snake = true;
+    bool kebab = true;
+};
+
+// The case variants template data includes for each kind of name. Every name
+// costs a conversion and a string per variant, and templates usually use one
+// or two of them, so data built for a template only has the ones it looks
+// up. The default is every variant.
+struct TemplateCases
+{
+    CaseVariants riv;
+    CaseVariants asset;
+    CaseVariants artboard;
+    CaseVariants animation;
+    CaseVariants stateMachine;
+    CaseVariants input;
+    CaseVariants textValueRun;
+    CaseVariants enumName;
+    CaseVariants enumValue;
+    CaseVariants viewModel;
+    CaseVariants property;
+    CaseVariants backing;
+    CaseVariants nestedArtboard;
+    // The other values derived from a name, which are built only if used
+    bool nestedArtboardArtboardPascal = true;
+    bool textValueRunDefaultSanitized = true;
+};
+
+// The variants the tags of `source` look up. Templates that don't parse get
+// every variant.
+TemplateCases casesForTemplate(const std::string& source);
+
+// Template data for interned structures. Each distinct structure is
+// converted once, however many files use it, and flagged `is_shared` if
+// more than one file does. Its last use takes the converted data rather than
+// copying it.
+template <typename T>
+class SharedTemplateData
+{
+public:
+    using Structures = std::vector<std::shared_ptr<const T>>;
+    using Convert = kainjow::mustache::data (*)(const T&,
+                                                const TemplateCases&);
+
+    // Items of list() are given their position as `indexName`, if any
+    SharedTemplateData(Convert convert,
+                       const TemplateCases& cases,
+                       const char* indexName = nullptr) :
+        m_convert(convert), m_cases(cases), m_indexName(indexName)
+    {}
+
+    // Must be called for every file before building any lists
+    void countFile(const Structures& structures)
+    {
+        std::unordered_set<const T*> seen;
+        for (const auto& structure : structures)
+        {
+            m_useCounts[structure.get()]++;
+            if (seen.insert(structure.get()).second &&
+                m_fileCounts[structure.get()]++ == 0)
+            {
+                m_firstSeen.push_back(structure.get());
+            }
+        }
+    }
+
+    std::vector<kainjow::mustache::data> list(const Structures& structures)
+    {
+        std::vector<kainjow::mustache::data> items;
+        items.reserve(structures.size());
+        for (size_t i = 0; i < structures.size(); i++)
+        {
+            auto data =
+                item(structures[i].get(), i == structures.size() - 1);
+            if (m_indexName)
+            {
+                data.set(m_indexName, std::to_string(i));
+            }
+            items.push_back(std::move(data));
+        }
+        return items;
+    }
+
+    // Every shared structure, once, in the order they first appear
+    std::vector<kainjow::mustache::data> sharedList()
+    {
+        std::vector<const T*> shared;
+        for (const T* structure : m_firstSeen)
+        {
+            if (m_fileCounts[structure] > 1)
+            {
+                shared.push_back(structure);
+            }
+        }
+        std::vector<kainjow::mustache::data> items;
+        items.reserve(shared.size());
+        for (size_t i = 0; i < shared.size(); i++)
+        {
+            items.push_back(item(shared[i], i == shared.size() - 1));
+        }
+        return items;
+    }
+
+private:
+    struct Converted
+    {
+        kainjow::mustache::data data;
+        size_t usesLeft;
+    };
+
+    kainjow::mustache::data item(const T* structure, bool last)
+    {
+        auto converted = m_converted.find(structure);
+        if (converted == m_converted.end())
+        {
+            auto data = m_convert(*structure, m_cases);
+            bool shared = m_fileCounts[structure] > 1;
+            data.set("is_shared", shared);
+            // Shared structures are also in sharedList()
+            size_t uses = m_useCounts[structure] + (shared ? 1 : 0);
+            converted =
+                m_converted.emplace(structure, Converted{std::move(data), uses})
+                    .first;
+        }
+
+        if (converted->second.usesLeft > 1)
+        {
+            converted->second.usesLeft--;
+            kainjow::mustache::data data = converted->second.data;
+            data.set("last", last);
+            return data;
+        }
+        kainjow::mustache::data data = std::move(converted->second.data);
+        m_converted.erase(converted);
+        data.set("last", last);
+        return data;
+    }
+
+    Convert m_convert;
+    TemplateCases m_cases;
+    const char* m_indexName;
+    std::unordered_map<const T*, size_t> m_fileCounts;
+    // How many times each structure appears across the files
+    std::unordered_map<const T*, size_t> m_useCounts;
+    std::vector<const T*> m_firstSeen;
+    std::unordered_map<const T*, Converted> m_converted;
+};
+
+// Template data for the structures of every file, which must all be counted
+// before any file's data is built
+struct SharedStructures
+{
+    explicit SharedStructures(const TemplateCases& cases = TemplateCases());
+
+    TemplateCases cases;
+    SharedTemplateData<EnumInfo> enums;
+    SharedTemplateData<ViewModelInfo> viewModels;
+    SharedTemplateData<ArtboardData> artboards;
+
+    void countFile(const RiveFileData& fileData);
+};
+
+// The file names exposed in {{#riv_files}}
+kainjow::mustache::data fileNameTemplateData(
+    const RiveFileData& fileData,
+    bool last,
+    const TemplateCases& cases = TemplateCases());
+
+// One entry of {{#riv_files}}. Every file must be counted in `shared` first.
+kainjow::mustache::data fileTemplateData(const RiveFileData& fileData,
+                                         SharedStructures& shared,
+                                         bool last);
+
+// The data for a whole template, with the case variants in `cases`
+kainjow::mustache::data buildTemplateData(
+    const std::vector<RiveFileData>& riveFileDataList,
+    const TemplateCases& cases = TemplateCases());
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+
+#include "kainjow/mustache.hpp"
+
+// Renders `templateStr` with kainjow, instrumented, which gives the same
+// output as TemplateRenderer::render(). `report` is set to where the render
+// went: for each section and each line of the template, how often it
+// rendered, the output it added, the variable lookups it made, the context
+// levels those walked and how many found nothing, and the time it took.
+std::string renderTemplateProfiled(const std::string& templateStr,
+                                   const kainjow::mustache::data& templateData,
+                                   std::string& report);
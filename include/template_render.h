@@ -0,0 +1,77 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "extraction_stages.h"
+#include "kainjow/mustache.hpp"
+#include "rive_file_data.h"
+#include "template_compiler.h"
+#include "template_data.h"
+#include "template_split.h"
+
+// A template compiled once for data of a schema type (template_schema.h),
+// which kainjow renders instead when the compiler can't
+class TemplateRenderer
+{
+public:
+    explicit TemplateRenderer(std::string source,
+                              const std::string& rootType = "Root");
+
+    const std::string& source() const { return m_source; }
+
+    std::string render(const kainjow::mustache::data& data) const;
+
+private:
+    std::string m_source;
+    std::optional<CompiledTemplate> m_compiled;
+};
+
+// The parts of a split template, compiled for the data each one is
+// rendered with
+struct SplitRenderers
+{
+    explicit SplitRenderers(const TemplateSplit& split);
+
+    TemplateRenderer header;
+    // Rendered with an item of {{#riv_files}}
+    TemplateRenderer item;
+    TemplateRenderer footer;
+    std::string empty;
+};
+
+// Renders each file's item of `split` on a thread per core, which gives the
+// same output as rendering the whole template. `cases` must include every
+// variant the template uses.
+std::string renderFilesInParallel(
+    const SplitRenderers& split,
+    const std::vector<RiveFileData>& riveFileDataList,
+    const TemplateCases& cases);
+
+// A template with the work that doesn't depend on the files done up front,
+// so that it can be rendered many times: the stages it needs, the case
+// variants its data needs, whether its files can be rendered in parallel
+// and the compiled template.
+class ParsedTemplate
+{
+public:
+    explicit ParsedTemplate(std::string source);
+
+    // Empty if the template parses. Templates that don't parse render
+    // kainjow's error message.
+    const std::string& error() const { return m_error; }
+
+    const ExtractionStages& stages() const { return m_stages; }
+
+    // Renders the template for `files`, a file per thread if the template's
+    // file section can be rendered on its own
+    std::string render(const std::vector<RiveFileData>& files) const;
+
+private:
+    std::string m_error;
+    ExtractionStages m_stages;
+    TemplateCases m_cases;
+    TemplateRenderer m_renderer;
+    std::optional<SplitRenderers> m_parallelSplit;
+};
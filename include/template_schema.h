@@ -0,0 +1,35 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+// The names buildTemplateData defines for templates, and what each one
+// holds, by the type of record they're in. Templates are compiled against
+// this once instead of against each render's data.
+
+enum class TemplateFieldKind
+{
+    String,
+    Bool,
+    // A record of `type`
+    Object,
+    // A list of records of `type`
+    List,
+};
+
+struct TemplateField
+{
+    std::string name;
+    TemplateFieldKind kind;
+    std::string type;
+};
+
+using TemplateSchema = std::map<std::string, std::vector<TemplateField>>;
+
+// "Root" is the data of a whole template and "File" an item of
+// {{#riv_files}}. Each type lists every name its records can have: case
+// variants are only there if TemplateCases asks for them, and
+// artboard_index isn't set in {{#shared_artboards}}, since it depends on the
+// file.
+const TemplateSchema& templateDataSchema();
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+// A template split around its last top-level {{#riv_files}} section, so that
+// the section can be rendered once per file as the files are extracted.
+// Rendering the header, each item and the footer in turn produces exactly
+// what rendering the whole template does.
+struct TemplateSplit
+{
+    // Rendered with only the file names in {{#riv_files}}
+    std::string header;
+    // Rendered for each file, with the file's data and the top-level data
+    std::string item;
+    // Rendered like the header
+    std::string footer;
+    // Output in place of the items when there are no files
+    std::string empty;
+};
+
+// How the parts of a split template are rendered
+enum class SplitMode
+{
+    // Each item is rendered as its file is extracted, so the header and
+    // footer only see the file names
+    Streaming,
+    // Every file is extracted first, so the header and footer see all of
+    // the data, and items can be rendered in any order
+    Parallel,
+};
+
+// Splits `source`, or returns nullopt with the reason in `error` if the
+// section can't be rendered on its own: its tags must be on lines of their
+// own, and its items can't use {{#riv_files}} or the shared_* lists, which
+// are only in the top-level data. When streaming, items can't use
+// {{is_shared}} either, and the header and footer can only use the file
+// names.
+std::optional<TemplateSplit> splitTemplate(const std::string& source,
+                                           SplitMode mode,
+                                           std::string& error);
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+
+#include "string_escape.h"
+
+// Output of the render functions generated for the built-in templates. Lines
+// are written straight into the output and dropped again if they turn out to
+// be blank lines holding section tags, like kainjow does.
+class TemplateWriter
+{
+public:
+    explicit TemplateWriter(std::string& output) :
+        m_output(output), m_lineStart(output.size())
+    {}
+
+    void text(const char* text, size_t size) { m_output.append(text, size); }
+
+    // Writes a {{variable}}
+    void escaped(const std::string& value)
+    {
+        appendHtmlEscaped(m_output, value);
+    }
+
+    // Writes a {{{variable}}}
+    void raw(const std::string& value) { m_output += value; }
+
+    // Marks the current line as holding a section tag
+    void section() { m_lineHasSection = true; }
+
+    void newline(const char* text, size_t size)
+    {
+        if (m_lineHasSection && lineIsBlank())
+        {
+            m_output.resize(m_lineStart);
+        }
+        else
+        {
+            m_output.append(text, size);
+        }
+        m_lineStart = m_output.size();
+        m_lineHasSection = false;
+    }
+
+    // Ends the last line
+    void finish()
+    {
+        if (m_lineHasSection && lineIsBlank())
+        {
+            m_output.resize(m_lineStart);
+        }
+    }
+
+private:
+    bool lineIsBlank() const
+    {
+        for (size_t i = m_lineStart; i < m_output.size(); i++)
+        {
+            if (m_output[i] != ' ' && m_output[i] != '\t')
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string& m_output;
+    size_t m_lineStart;
+    bool m_lineHasSection = false;
+};
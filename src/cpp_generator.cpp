@@ -0,0 +1,495 @@
+#include "cpp_generator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "naming.h"
+
+// Must match detail::hashName in the generated header
+static uint32_t hashName(const std::string& name, uint32_t seed)
+{
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : name)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+struct PerfectHash
+{
+    // Power of two; both the bucket and the slot count
+    uint32_t size = 1;
+    std::vector<uint32_t> seeds;
+    std::vector<int32_t> slots;
+};
+
+// Builds a hash-and-displace perfect hash over the distinct names, where
+// each slot holds the index of the first element with that name. Keys are
+// hashed into buckets, and buckets are placed largest first by searching
+// for a seed that sends all of their keys to free slots. The result only
+// depends on the names, so output is deterministic. Returns nullopt if the
+// table would outgrow maxTableSize.
+static std::optional<PerfectHash> buildPerfectHash(
+    const std::vector<std::string>& names)
+{
+    std::vector<std::pair<const std::string*, int32_t>> keys;
+    std::unordered_set<std::string> seen;
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        if (seen.insert(names[i]).second)
+        {
+            keys.emplace_back(&names[i], static_cast<int32_t>(i));
+        }
+    }
+
+    const uint32_t maxSeed = 1 << 16;
+    // Keeps the doubling below from overflowing or emitting huge arrays
+    const uint32_t maxTableSize = 1 << 24;
+    PerfectHash table;
+    while (table.size < keys.size() && table.size < maxTableSize)
+    {
+        table.size <<= 1;
+    }
+
+    while (table.size >= keys.size())
+    {
+        const uint32_t mask = table.size - 1;
+        std::vector<std::vector<size_t>> buckets(table.size);
+        for (size_t k = 0; k < keys.size(); k++)
+        {
+            buckets[hashName(*keys[k].first, 0) & mask].push_back(k);
+        }
+
+        std::vector<uint32_t> order(table.size);
+        for (uint32_t b = 0; b < table.size; b++)
+        {
+            order[b] = b;
+        }
+        std::stable_sort(order.begin(),
+                         order.end(),
+                         [&](uint32_t a, uint32_t b) {
+                             return buckets[a].size() > buckets[b].size();
+                         });
+
+        table.seeds.assign(table.size, 0);
+        table.slots.assign(table.size, -1);
+        bool placed = true;
+        std::vector<uint32_t> bucketSlots;
+        for (uint32_t b : order)
+        {
+            const auto& bucket = buckets[b];
+            if (bucket.empty())
+            {
+                break;
+            }
+
+            bool found = false;
+            for (uint32_t seed = 1; seed < maxSeed && !found; seed++)
+            {
+                bucketSlots.clear();
+                found = true;
+                for (size_t k : bucket)
+                {
+                    uint32_t slot = hashName(*keys[k].first, seed) & mask;
+                    if (table.slots[slot] != -1 ||
+                        std::find(bucketSlots.begin(),
+                                  bucketSlots.end(),
+                                  slot) != bucketSlots.end())
+                    {
+                        found = false;
+                        break;
+                    }
+                    bucketSlots.push_back(slot);
+                }
+                if (found)
+                {
+                    table.seeds[b] = seed;
+                    for (size_t i = 0; i < bucket.size(); i++)
+                    {
+                        table.slots[bucketSlots[i]] = keys[bucket[i]].second;
+                    }
+                }
+            }
+
+            if (!found)
+            {
+                placed = false;
+                break;
+            }
+        }
+
+        if (placed)
+        {
+            return table;
+        }
+        if (table.size == maxTableSize)
+        {
+            break;
+        }
+        // Unlucky hash distribution, retry with more room
+        table.size <<= 1;
+    }
+
+    std::cerr << "Error: Failed to build the name lookup table for "
+              << keys.size() << " names" << std::endl;
+    return std::nullopt;
+}
+
+// Escapes a string for use in a C++ string literal. Control characters use
+// octal escapes, which unlike \x escapes can't swallow following characters.
+static std::string cppStringLiteral(const std::string& str)
+{
+    std::string literal = "\"";
+    for (char c : str)
+    {
+        auto byte = static_cast<unsigned char>(c);
+        switch (c)
+        {
+            case '\n':
+                literal += "\\n";
+                break;
+            case '\r':
+                literal += "\\r";
+                break;
+            case '\t':
+                literal += "\\t";
+                break;
+            case '\"':
+                literal += "\\\"";
+                break;
+            case '\\':
+                literal += "\\\\";
+                break;
+            case '?':
+                // Avoids trigraphs in pre-C++17 tooling
+                literal += "\\?";
+                break;
+            default:
+                if (byte < 0x20 || byte == 0x7f)
+                {
+                    literal += '\\';
+                    literal += static_cast<char>('0' + ((byte >> 6) & 7));
+                    literal += static_cast<char>('0' + ((byte >> 3) & 7));
+                    literal += static_cast<char>('0' + (byte & 7));
+                }
+                else
+                {
+                    literal += c;
+                }
+        }
+    }
+    literal += '"';
+    return literal;
+}
+
+static void writeNumbers(std::ostream& out,
+                         const std::string& indent,
+                         const char* type,
+                         const char* name,
+                         const std::vector<int64_t>& values)
+{
+    out << indent << "static constexpr " << type << " " << name << "["
+        << values.size() << "] = {";
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        if (i % 16 == 0)
+        {
+            out << "\n" << indent << "    ";
+        }
+        else
+        {
+            out << " ";
+        }
+        out << values[i] << ",";
+    }
+    out << "\n" << indent << "};\n";
+}
+
+// Writes the count, names, perfect-hash table and indexOf() lookup for a
+// list of named elements into the enclosing struct
+static bool writeNameTable(std::ostream& out,
+                           const std::string& indent,
+                           const std::vector<std::string>& names)
+{
+    out << indent << "static constexpr uint32_t count = " << names.size()
+        << ";\n";
+    if (names.empty())
+    {
+        out << indent << "static constexpr int32_t indexOf(std::string_view)\n"
+            << indent << "{\n"
+            << indent << "    return -1;\n"
+            << indent << "}\n";
+        return true;
+    }
+
+    auto hash = buildPerfectHash(names);
+    if (!hash)
+    {
+        return false;
+    }
+    const PerfectHash& table = *hash;
+
+    out << indent << "static constexpr std::string_view names[" << names.size()
+        << "] = {\n";
+    for (const auto& name : names)
+    {
+        out << indent << "    " << cppStringLiteral(name) << ",\n";
+    }
+    out << indent << "};\n";
+    writeNumbers(out,
+                 indent,
+                 "uint32_t",
+                 "seeds",
+                 std::vector<int64_t>(table.seeds.begin(), table.seeds.end()));
+    writeNumbers(out,
+                 indent,
+                 "int32_t",
+                 "slots",
+                 std::vector<int64_t>(table.slots.begin(), table.slots.end()));
+    out << indent << "static constexpr int32_t indexOf(std::string_view name)\n"
+        << indent << "{\n"
+        << indent << "    return detail::lookup<" << table.size
+        << ">(names, seeds, slots, name);\n"
+        << indent << "}\n";
+    return true;
+}
+
+static void writeElementStart(std::ostream& out,
+                              const std::string& indent,
+                              const std::string& typeName,
+                              const std::string& name,
+                              size_t index)
+{
+    out << "\n"
+        << indent << "struct " << typeName << "\n"
+        << indent << "{\n"
+        << indent << "    static constexpr std::string_view name = "
+        << cppStringLiteral(name) << ";\n"
+        << indent << "    static constexpr uint32_t index = " << index
+        << ";\n";
+}
+
+static const char* inputTypeName(const std::string& type)
+{
+    if (type == "number" || type == "boolean" || type == "trigger")
+    {
+        return type.c_str();
+    }
+    return "unknown";
+}
+
+static bool writeArtboard(std::ostream& out,
+                          const std::string& indent,
+                          const std::string& typeName,
+                          const ArtboardData& artboard,
+                          size_t index)
+{
+    const std::string inner = indent + "    ";
+    writeElementStart(out, indent, typeName, artboard.artboardName, index);
+
+    out << "\n" << inner << "struct animations\n" << inner << "{\n";
+    if (!writeNameTable(out, inner + "    ", artboard.animations))
+    {
+        return false;
+    }
+    std::unordered_set<std::string> usedAnimationNames;
+    for (size_t i = 0; i < artboard.animations.size(); i++)
+    {
+        const auto& animation = artboard.animations[i];
+        writeElementStart(out,
+                          inner + "    ",
+                          makeUnique(toPascalCase(animation),
+                                     usedAnimationNames),
+                          animation,
+                          i);
+        out << inner << "    };\n";
+    }
+    out << inner << "};\n";
+
+    std::vector<std::string> stateMachineNames;
+    for (const auto& stateMachine : artboard.stateMachines)
+    {
+        stateMachineNames.push_back(stateMachine.first);
+    }
+    out << "\n" << inner << "struct state_machines\n" << inner << "{\n";
+    if (!writeNameTable(out, inner + "    ", stateMachineNames))
+    {
+        return false;
+    }
+    std::unordered_set<std::string> usedStateMachineNames;
+    for (size_t i = 0; i < artboard.stateMachines.size(); i++)
+    {
+        const auto& stateMachine = artboard.stateMachines[i];
+        const std::string smIndent = inner + "    ";
+        writeElementStart(out,
+                          smIndent,
+                          makeUnique(toPascalCase(stateMachine.first),
+                                     usedStateMachineNames),
+                          stateMachine.first,
+                          i);
+
+        std::vector<std::string> inputNames;
+        for (const auto& input : stateMachine.second)
+        {
+            inputNames.push_back(input.name);
+        }
+        out << "\n"
+            << smIndent << "    struct inputs\n"
+            << smIndent << "    {\n";
+        if (!writeNameTable(out, smIndent + "        ", inputNames))
+        {
+            return false;
+        }
+        std::unordered_set<std::string> usedInputNames;
+        for (size_t j = 0; j < stateMachine.second.size(); j++)
+        {
+            const auto& input = stateMachine.second[j];
+            const std::string inputIndent = smIndent + "        ";
+            writeElementStart(out,
+                              inputIndent,
+                              makeUnique(toPascalCase(input.name),
+                                         usedInputNames),
+                              input.name,
+                              j);
+            out << inputIndent
+                << "    static constexpr InputType type = InputType::"
+                << inputTypeName(input.type) << ";\n"
+                << inputIndent << "};\n";
+        }
+        out << smIndent << "    };\n" << smIndent << "};\n";
+    }
+    out << inner << "};\n";
+
+    out << "\n" << inner << "struct text_runs\n" << inner << "{\n";
+    std::unordered_set<std::string> usedTextRunNames;
+    for (const auto& textRun : artboard.textValueRuns)
+    {
+        out << inner << "    static constexpr std::string_view "
+            << makeUnique(toPascalCase(textRun.name), usedTextRunNames)
+            << " = " << cppStringLiteral(textRun.name) << ";\n";
+    }
+    out << inner << "};\n";
+
+    out << indent << "};\n";
+    return true;
+}
+
+std::optional<std::string> generateCppHeader(
+    const std::vector<RiveFileData>& riveFiles,
+    const std::string& generatedFileName)
+{
+    std::ostringstream out;
+    out << "// " << generatedFileName << ".hpp\n"
+        << R"(
+// Generated by the Rive Code Generator, do not edit.
+//
+// Every artboard, animation, state machine and input is a struct holding its
+// name and its index in the Rive file, so runtimes can bind by index. Each
+// list also provides indexOf(name), a compile-time perfect-hash lookup that
+// costs one hash and one string comparison, returning -1 for unknown names.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace rive_generated
+{
+enum class InputType
+{
+    number,
+    boolean,
+    trigger,
+    unknown,
+};
+
+namespace detail
+{
+constexpr uint32_t hashName(std::string_view name, uint32_t seed)
+{
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : name)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+template <uint32_t Size, std::size_t Count>
+constexpr int32_t lookup(const std::string_view (&names)[Count],
+                         const uint32_t (&seeds)[Size],
+                         const int32_t (&slots)[Size],
+                         std::string_view name)
+{
+    uint32_t seed = seeds[hashName(name, 0) & (Size - 1)];
+    int32_t index = slots[hashName(name, seed) & (Size - 1)];
+    return index >= 0 && names[index] == name ? index : -1;
+}
+} // namespace detail
+)";
+
+    // File structs share the namespace with InputType and detail
+    std::unordered_set<std::string> usedFileNames = {"InputType"};
+    for (const auto& riveFile : riveFiles)
+    {
+        out << "\n"
+            << "struct " << makeUnique(riveFile.rivPascalCase, usedFileNames)
+            << "\n"
+            << "{\n"
+            << "    static constexpr std::string_view name = "
+            << cppStringLiteral(riveFile.rivName) << ";\n"
+            << "\n"
+            << "    struct artboards\n"
+            << "    {\n";
+
+        std::vector<std::string> artboardNames;
+        for (const auto& artboard : riveFile.artboards)
+        {
+            artboardNames.push_back(artboard->artboardName);
+        }
+        if (!writeNameTable(out, "        ", artboardNames))
+        {
+            return std::nullopt;
+        }
+
+        std::unordered_set<std::string> usedArtboardNames;
+        for (size_t i = 0; i < riveFile.artboards.size(); i++)
+        {
+            const auto& artboard = *riveFile.artboards[i];
+            if (!writeArtboard(out,
+                               "        ",
+                               makeUnique(artboard.artboardPascalCase,
+                                          usedArtboardNames),
+                               artboard,
+                               i))
+            {
+                return std::nullopt;
+            }
+        }
+
+        out << "    };\n"
+            << "};\n";
+    }
+
+    out << "} // namespace rive_generated\n";
+    return out.str();
+}
+
+ExtractionStages cppHeaderStages()
+{
+    ExtractionStages stages;
+    stages.artboards = true;
+    stages.animations = true;
+    stages.stateMachines = true;
+    stages.textValueRuns = true;
+    return stages;
+}
@@ -0,0 +1,241 @@
+#include "extraction_stages.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "kainjow/mustache.hpp"
+
+using Component = kainjow::mustache::component<std::string>;
+using TagType = kainjow::mustache::tag_type;
+using Stage = bool ExtractionStages::*;
+
+static const std::vector<std::pair<std::string, Stage>> stagesByName = {
+    {"assets", &ExtractionStages::assets},
+    {"enums", &ExtractionStages::enums},
+    {"view_models", &ExtractionStages::viewModels},
+    {"artboards", &ExtractionStages::artboards},
+    {"animations", &ExtractionStages::animations},
+    {"state_machines", &ExtractionStages::stateMachines},
+    {"text_value_runs", &ExtractionStages::textValueRuns},
+    {"nested_text_value_runs", &ExtractionStages::nestedTextValueRuns},
+    {"nested_artboards", &ExtractionStages::nestedArtboards},
+};
+
+// Prefixes of the fields each stage fills
+static const std::vector<std::pair<std::string, Stage>> stagesByPrefix = {
+    {"asset_", &ExtractionStages::assets},
+    {"enum_", &ExtractionStages::enums},
+    {"view_model_", &ExtractionStages::viewModels},
+    {"property_", &ExtractionStages::viewModels},
+    {"backing_", &ExtractionStages::viewModels},
+    {"artboard_", &ExtractionStages::artboards},
+    {"animation_", &ExtractionStages::animations},
+    {"state_machine_", &ExtractionStages::stateMachines},
+    {"input_", &ExtractionStages::stateMachines},
+    {"text_value_run_", &ExtractionStages::textValueRuns},
+    {"nested_text_value_run_", &ExtractionStages::nestedTextValueRuns},
+    {"nested_artboard_", &ExtractionStages::nestedArtboards},
+};
+
+// Lists and flags that don't follow the prefixes
+static const std::unordered_map<std::string, Stage> stagesByTagName = {
+    {"properties", &ExtractionStages::viewModels},
+    {"is_view_model", &ExtractionStages::viewModels},
+    {"is_enum", &ExtractionStages::viewModels},
+    {"is_string", &ExtractionStages::viewModels},
+    {"is_number", &ExtractionStages::viewModels},
+    {"is_integer", &ExtractionStages::viewModels},
+    {"is_boolean", &ExtractionStages::viewModels},
+    {"is_color", &ExtractionStages::viewModels},
+    {"is_list", &ExtractionStages::viewModels},
+    {"is_trigger", &ExtractionStages::viewModels},
+    {"inputs", &ExtractionStages::stateMachines},
+    {"shared_enums", &ExtractionStages::enums},
+    {"shared_view_models", &ExtractionStages::viewModels},
+};
+
+static void addArtboardStages(ExtractionStages& stages)
+{
+    stages.artboards = true;
+    stages.animations = true;
+    stages.stateMachines = true;
+    stages.textValueRuns = true;
+    stages.nestedTextValueRuns = true;
+    stages.nestedArtboards = true;
+}
+
+// Every artboard part needs the artboards to hang off
+static ExtractionStages withArtboards(ExtractionStages stages)
+{
+    stages.artboards = stages.artboards || stages.animations ||
+                       stages.stateMachines || stages.textValueRuns ||
+                       stages.nestedTextValueRuns || stages.nestedArtboards;
+    return stages;
+}
+
+ExtractionStages ExtractionStages::all()
+{
+    ExtractionStages stages;
+    stages.assets = true;
+    stages.enums = true;
+    stages.viewModels = true;
+    addArtboardStages(stages);
+    return stages;
+}
+
+const std::vector<std::string>& extractionStageNames()
+{
+    static const std::vector<std::string> names = []()
+    {
+        std::vector<std::string> names;
+        for (const auto& entry : stagesByName)
+        {
+            names.push_back(entry.first);
+        }
+        return names;
+    }();
+    return names;
+}
+
+ExtractionStages stagesFromNames(const std::vector<std::string>& names)
+{
+    ExtractionStages stages;
+    for (const auto& name : names)
+    {
+        for (const auto& entry : stagesByName)
+        {
+            if (entry.first == name)
+            {
+                stages.*entry.second = true;
+            }
+        }
+    }
+    return withArtboards(stages);
+}
+
+uint32_t stagesToBits(const ExtractionStages& stages)
+{
+    uint32_t bits = 0;
+    for (size_t i = 0; i < stagesByName.size(); i++)
+    {
+        if (stages.*stagesByName[i].second)
+        {
+            bits |= 1u << i;
+        }
+    }
+    return bits;
+}
+
+ExtractionStages stagesFromBits(uint32_t bits)
+{
+    ExtractionStages stages;
+    for (size_t i = 0; i < stagesByName.size(); i++)
+    {
+        stages.*stagesByName[i].second = (bits & (1u << i)) != 0;
+    }
+    return withArtboards(stages);
+}
+
+// Adds the stage one part of a dotted tag name comes from, if any
+static void addStageForName(ExtractionStages& stages, const std::string& name)
+{
+    if (name == "is_shared" || name == "shared_artboards")
+    {
+        addArtboardStages(stages);
+        return;
+    }
+    auto tagName = stagesByTagName.find(name);
+    if (tagName != stagesByTagName.end())
+    {
+        stages.*tagName->second = true;
+        return;
+    }
+    for (const auto& entry : stagesByName)
+    {
+        if (entry.first == name)
+        {
+            stages.*entry.second = true;
+            return;
+        }
+    }
+    for (const auto& entry : stagesByPrefix)
+    {
+        if (name.compare(0, entry.first.size(), entry.first) == 0)
+        {
+            stages.*entry.second = true;
+            return;
+        }
+    }
+}
+
+static void addTagNames(std::unordered_set<std::string>& names,
+                        const Component& component)
+{
+    switch (component.tag.type)
+    {
+        case TagType::variable:
+        case TagType::unescaped_variable:
+        case TagType::section_begin:
+        case TagType::section_begin_inverted:
+        case TagType::partial:
+        {
+            const std::string& name = component.tag.name;
+            size_t start = 0;
+            while (start <= name.size())
+            {
+                size_t end = name.find('.', start);
+                if (end == std::string::npos)
+                {
+                    end = name.size();
+                }
+                names.insert(name.substr(start, end - start));
+                start = end + 1;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    for (const auto& child : component.children)
+    {
+        addTagNames(names, child);
+    }
+}
+
+std::optional<std::unordered_set<std::string>> templateTagNames(
+    const std::string& source)
+{
+    kainjow::mustache::context<std::string> context;
+    kainjow::mustache::context_internal<std::string> parseContext{context};
+    Component root;
+    std::string error;
+    kainjow::mustache::parser<std::string> parser{source,
+                                                  parseContext,
+                                                  root,
+                                                  error};
+    if (!error.empty())
+    {
+        return std::nullopt;
+    }
+
+    std::unordered_set<std::string> names;
+    addTagNames(names, root);
+    return names;
+}
+
+ExtractionStages stagesForTemplate(const std::string& source)
+{
+    auto names = templateTagNames(source);
+    if (!names)
+    {
+        return ExtractionStages::all();
+    }
+
+    ExtractionStages stages;
+    for (const auto& name : *names)
+    {
+        addStageForName(stages, name);
+    }
+    return withArtboards(stages);
+}
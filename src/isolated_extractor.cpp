@@ -0,0 +1,477 @@
+#include "isolated_extractor.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+
+bool extractRiveFilesIsolated(
+    const std::vector<std::string>&,
+    const ExtractionStages&,
+    const IsolationLimits&,
+    StructureInterner*,
+    const std::function<void(size_t, RiveFileData&&)>&)
+{
+    std::cerr << "Error: --isolate isn't supported on Windows" << std::endl;
+    return false;
+}
+
+#else
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <cstring>
+#include <map>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "parallel_for.h"
+#include "partial_results.h"
+#include "rive_extractor.h"
+
+using Clock = std::chrono::steady_clock;
+
+// How many files past the first one not yet passed to onFile are handed out
+// per worker. Files finished early wait for the ones before them, so this
+// bounds how many are held at once.
+static constexpr size_t filesAheadPerWorker = 4;
+
+// Returns false if the other end has closed
+static bool writeAll(int fd, const void* data, size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0)
+    {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+// Returns false if the other end closes before `size` bytes are read
+static bool readAll(int fd, void* data, size_t size)
+{
+    char* bytes = static_cast<char*>(data);
+    while (size > 0)
+    {
+        ssize_t got = read(fd, bytes, size);
+        if (got < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (got <= 0)
+        {
+            return false;
+        }
+        bytes += got;
+        size -= got;
+    }
+    return true;
+}
+
+// A worker's loop: extracts the files whose indices arrive on `requests` and
+// writes each one's partial results to `results`, after their size. A size
+// of 0 means the file couldn't be read, with the error already printed.
+// Returns once `requests` closes.
+static void runWorker(int requests,
+                      int results,
+                      const std::vector<std::string>& riveFiles,
+                      const ExtractionStages& stages)
+{
+    uint64_t index;
+    while (readAll(requests, &index, sizeof(index)))
+    {
+        std::string message;
+        try
+        {
+            StructureInterner interner;
+            auto data = processRiveFile(riveFiles[index], interner, stages);
+            if (data)
+            {
+                PartialResults partial;
+                partial.stages = stages;
+                partial.files.push_back({riveFiles[index], std::move(*data)});
+                message = serializePartialResults(partial);
+            }
+        }
+        catch (const std::bad_alloc&)
+        {
+            message.clear();
+            std::cerr << "Error: Ran out of memory extracting "
+                      << riveFiles[index] << std::endl;
+        }
+        uint64_t size = message.size();
+        if (!writeAll(results, &size, sizeof(size)) ||
+            !writeAll(results, message.data(), message.size()))
+        {
+            return;
+        }
+    }
+}
+
+// How a worker that stopped answering ended, from its wait status
+static std::string exitReason(int status)
+{
+    if (WIFSIGNALED(status))
+    {
+        return "was killed by signal " + std::to_string(WTERMSIG(status)) +
+               " (" + strsignal(WTERMSIG(status)) + ")";
+    }
+    if (WIFEXITED(status))
+    {
+        return "exited with status " + std::to_string(WEXITSTATUS(status));
+    }
+    return "stopped";
+}
+
+struct Worker
+{
+    // -1 once it has stopped, until it's replaced
+    pid_t pid = -1;
+    // The pool's ends of its pipes: file indices go out on one and results
+    // come back on the other
+    int requests = -1;
+    int results = -1;
+    // The file it's extracting, if any, and when it must be done by
+    std::optional<size_t> file;
+    Clock::time_point deadline;
+};
+
+// Ignores SIGPIPE until it's destroyed, then restores the previous handler
+class PipeSignalIgnored
+{
+public:
+    PipeSignalIgnored() : m_previous(std::signal(SIGPIPE, SIG_IGN)) {}
+    ~PipeSignalIgnored()
+    {
+        if (m_previous != SIG_ERR)
+        {
+            std::signal(SIGPIPE, m_previous);
+        }
+    }
+
+private:
+    void (*m_previous)(int);
+};
+
+class WorkerPool
+{
+public:
+    WorkerPool(const std::vector<std::string>& riveFiles,
+               const ExtractionStages& stages,
+               const IsolationLimits& limits) :
+        m_riveFiles(riveFiles), m_stages(stages), m_limits(limits)
+    {}
+
+    ~WorkerPool()
+    {
+        // Idle workers exit once their requests close
+        for (auto& worker : m_workers)
+        {
+            if (worker.pid >= 0)
+            {
+                stop(worker, worker.file.has_value());
+            }
+        }
+    }
+
+    bool run(StructureInterner* interner,
+             const std::function<void(size_t, RiveFileData&&)>& onFile)
+    {
+        // A worker that dies leaves its request pipe without a reader, and
+        // writing to that mustn't end the whole run
+        PipeSignalIgnored pipeSignalIgnored;
+
+        size_t workerCount =
+            std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u),
+                             m_riveFiles.size());
+        m_workers.resize(workerCount);
+        size_t filesAhead = workerCount * filesAheadPerWorker;
+
+        size_t nextFile = 0;
+        size_t nextDone = 0;
+        // Files that finished before one ahead of them, nullopt if they
+        // couldn't be read
+        std::map<size_t, std::optional<RiveFileData>> finished;
+        while (nextDone < m_riveFiles.size())
+        {
+            for (auto& worker : m_workers)
+            {
+                if (worker.pid < 0 && !start(worker))
+                {
+                    return false;
+                }
+                if (!worker.file && nextFile < m_riveFiles.size() &&
+                    nextFile < nextDone + filesAhead)
+                {
+                    if (!send(worker, nextFile))
+                    {
+                        return false;
+                    }
+                    nextFile++;
+                }
+            }
+
+            if (!waitForWorkers(interner, finished))
+            {
+                return false;
+            }
+
+            for (auto done = finished.find(nextDone); done != finished.end();
+                 done = finished.find(nextDone))
+            {
+                if (done->second)
+                {
+                    onFile(nextDone, std::move(*done->second));
+                }
+                finished.erase(done);
+                nextDone++;
+            }
+        }
+        return true;
+    }
+
+private:
+    bool start(Worker& worker)
+    {
+        int requestPipe[2];
+        int resultPipe[2];
+        if (pipe(requestPipe) != 0)
+        {
+            std::cerr << "Error: Unable to create a pipe for a worker: "
+                      << strerror(errno) << std::endl;
+            return false;
+        }
+        if (pipe(resultPipe) != 0)
+        {
+            std::cerr << "Error: Unable to create a pipe for a worker: "
+                      << strerror(errno) << std::endl;
+            close(requestPipe[0]);
+            close(requestPipe[1]);
+            return false;
+        }
+
+        // Otherwise the worker would write what's buffered a second time
+        std::cout.flush();
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            std::cerr << "Error: Unable to start a worker process: "
+                      << strerror(errno) << std::endl;
+            for (int fd : {requestPipe[0],
+                           requestPipe[1],
+                           resultPipe[0],
+                           resultPipe[1]})
+            {
+                close(fd);
+            }
+            return false;
+        }
+
+        if (pid == 0)
+        {
+            // Holding the other workers' pipes open would stop the pool
+            // from seeing them close when those workers end
+            for (const auto& other : m_workers)
+            {
+                if (other.pid >= 0)
+                {
+                    close(other.requests);
+                    close(other.results);
+                }
+            }
+            close(requestPipe[1]);
+            close(resultPipe[0]);
+            if (m_limits.memoryLimit > 0)
+            {
+                rlimit limit;
+                limit.rlim_cur = m_limits.memoryLimit;
+                limit.rlim_max = m_limits.memoryLimit;
+                setrlimit(RLIMIT_AS, &limit);
+            }
+            // The pool already has a worker per core
+            runParallelForSerially();
+            runWorker(requestPipe[0], resultPipe[1], m_riveFiles, m_stages);
+            std::cout.flush();
+            // Without the parent's static destructors and exit handlers
+            _exit(0);
+        }
+
+        close(requestPipe[0]);
+        close(resultPipe[1]);
+        worker = Worker();
+        worker.pid = pid;
+        worker.requests = requestPipe[1];
+        worker.results = resultPipe[0];
+        return true;
+    }
+
+    // Ends a worker, killing it first if it may still be busy, and returns
+    // its wait status
+    int stop(Worker& worker, bool kill)
+    {
+        if (kill)
+        {
+            ::kill(worker.pid, SIGKILL);
+        }
+        close(worker.requests);
+        close(worker.results);
+        int status = 0;
+        while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR)
+        {
+        }
+        worker = Worker();
+        return status;
+    }
+
+    bool send(Worker& worker, size_t file)
+    {
+        uint64_t index = file;
+        if (!writeAll(worker.requests, &index, sizeof(index)))
+        {
+            // It ended while idle, so no file is lost
+            stop(worker, false);
+            if (!start(worker))
+            {
+                return false;
+            }
+            if (!writeAll(worker.requests, &index, sizeof(index)))
+            {
+                std::cerr << "Error: A worker process ended before it could "
+                             "extract "
+                          << m_riveFiles[file] << std::endl;
+                return false;
+            }
+        }
+        worker.file = file;
+        worker.deadline = Clock::now() + m_limits.timeout;
+        return true;
+    }
+
+    // Waits until a busy worker sends its result, ends or runs out of time,
+    // and records in `finished` what became of the files of those that did
+    bool waitForWorkers(StructureInterner* interner,
+                        std::map<size_t, std::optional<RiveFileData>>& finished)
+    {
+        std::vector<pollfd> fds;
+        std::vector<Worker*> busy;
+        Clock::time_point deadline = Clock::time_point::max();
+        for (auto& worker : m_workers)
+        {
+            if (worker.file)
+            {
+                fds.push_back({worker.results, POLLIN, 0});
+                busy.push_back(&worker);
+                deadline = std::min(deadline, worker.deadline);
+            }
+        }
+
+        auto wait = std::chrono::ceil<std::chrono::milliseconds>(
+            std::max(deadline - Clock::now(), Clock::duration::zero()));
+        int ready = poll(fds.data(),
+                         fds.size(),
+                         static_cast<int>(
+                             std::min<int64_t>(wait.count(), INT_MAX)));
+        if (ready < 0 && errno != EINTR)
+        {
+            std::cerr << "Error: Unable to wait for the worker processes: "
+                      << strerror(errno) << std::endl;
+            return false;
+        }
+
+        Clock::time_point now = Clock::now();
+        for (size_t i = 0; i < busy.size(); i++)
+        {
+            Worker& worker = *busy[i];
+            size_t file = *worker.file;
+            if (ready > 0 && fds[i].revents != 0)
+            {
+                finished[file] = receive(worker, interner);
+            }
+            else if (now >= worker.deadline)
+            {
+                std::cerr << "Error: Extracting " << m_riveFiles[file]
+                          << " took longer than " << m_limits.timeout.count()
+                          << " seconds, skipping it" << std::endl;
+                stop(worker, true);
+                finished[file] = std::nullopt;
+            }
+        }
+        return true;
+    }
+
+    // The data of the worker's file, or nullopt if it couldn't be read or
+    // the worker ended, with the error already printed
+    std::optional<RiveFileData> receive(Worker& worker,
+                                        StructureInterner* interner)
+    {
+        const std::string& path = m_riveFiles[*worker.file];
+        worker.file.reset();
+
+        uint64_t size = 0;
+        std::string message;
+        bool received = readAll(worker.results, &size, sizeof(size));
+        if (received)
+        {
+            message.resize(size);
+            received = readAll(worker.results, &message[0], size);
+        }
+        if (!received)
+        {
+            int status = stop(worker, true);
+            std::cerr << "Error: The worker extracting " << path << " "
+                      << exitReason(status) << ", skipping it" << std::endl;
+            return std::nullopt;
+        }
+        if (size == 0)
+        {
+            return std::nullopt;
+        }
+
+        StructureInterner ownInterner;
+        auto partial = deserializePartialResults(message,
+                                                 path,
+                                                 interner ? *interner
+                                                          : ownInterner);
+        if (!partial || partial->files.size() != 1)
+        {
+            return std::nullopt;
+        }
+        return std::move(partial->files[0].data);
+    }
+
+    const std::vector<std::string>& m_riveFiles;
+    ExtractionStages m_stages;
+    IsolationLimits m_limits;
+    std::vector<Worker> m_workers;
+};
+
+bool extractRiveFilesIsolated(
+    const std::vector<std::string>& riveFiles,
+    const ExtractionStages& stages,
+    const IsolationLimits& limits,
+    StructureInterner* interner,
+    const std::function<void(size_t, RiveFileData&&)>& onFile)
+{
+    WorkerPool pool(riveFiles, stages, limits);
+    return pool.run(interner, onFile);
+}
+
+#endif
@@ -0,0 +1,256 @@
+#include "json_generator.h"
+
+#include <unordered_set>
+
+#include "naming.h"
+#include "string_escape.h"
+
+static const size_t kFlushSize = 64 * 1024;
+
+JsonGenerator::JsonGenerator(std::ostream& output) : m_output(output)
+{
+    m_buffer.reserve(kFlushSize * 2);
+    write("{\n  \"riveMeta\": {\n");
+}
+
+void JsonGenerator::writeString(const std::string& str)
+{
+    m_buffer += '"';
+    appendJsonEscaped(m_buffer, str);
+    m_buffer += '"';
+}
+
+void JsonGenerator::writeField(const char* indent,
+                               const char* key,
+                               const std::string& value,
+                               bool last)
+{
+    write(indent);
+    write(key);
+    writeString(value);
+    write(last ? "\n" : ",\n");
+}
+
+// Lists mirror the template's `{{^last}},{{/last}}` separators: every item
+// but the first is preceded by a comma, and an empty list leaves a line
+// holding only the section's indentation.
+void JsonGenerator::beginItem(bool& first)
+{
+    if (!first)
+    {
+        write(",\n");
+    }
+    first = false;
+}
+
+void JsonGenerator::endList(bool first, const char* indent)
+{
+    if (first)
+    {
+        write(indent);
+    }
+    write("\n");
+}
+
+void JsonGenerator::flushIfFull()
+{
+    if (m_buffer.size() >= kFlushSize)
+    {
+        m_output.write(m_buffer.data(), m_buffer.size());
+        m_buffer.clear();
+    }
+}
+
+void JsonGenerator::addFile(const RiveFileData& riveFile)
+{
+    beginItem(m_firstFile);
+    write("    ");
+    writeString(riveFile.rivCameCase);
+    write(": {\n");
+
+    write("      \"assets\": {\n");
+    bool first = true;
+    for (const auto& asset : riveFile.assets)
+    {
+        beginItem(first);
+        write("        ");
+        writeString(toCamelCase(asset.name));
+        write(": {\n");
+        writeField("          ", "\"name\": ", asset.name);
+        writeField("          ", "\"type\": ", asset.type);
+        writeField("          ", "\"assetId\": ", asset.assetId);
+        writeField("          ", "\"cdnUuid\": ", asset.cdnUuid);
+        writeField("          ", "\"cdnBaseUrl\": ", asset.cdnBaseUrl, true);
+        write("        }");
+    }
+    endList(first, "        ");
+    write("      },\n");
+
+    write("      \"enums\": {\n");
+    first = true;
+    for (const auto& enumPtr : riveFile.enums)
+    {
+        const auto& enumInfo = *enumPtr;
+        beginItem(first);
+        write("        ");
+        writeString(toCamelCase(enumInfo.name));
+        write(": {\n");
+        writeField("          ", "\"name\": ", enumInfo.name);
+        write("          \"values\": {\n");
+        bool firstValue = true;
+        for (const auto& value : enumInfo.values)
+        {
+            beginItem(firstValue);
+            write("            ");
+            writeString(toCamelCase(value.key));
+            write(": ");
+            writeString(value.key);
+        }
+        endList(firstValue, "            ");
+        write("          }\n");
+        write("        }");
+    }
+    endList(first, "        ");
+    write("      },\n");
+
+    write("      \"viewModels\": {\n");
+    first = true;
+    for (const auto& viewModelPtr : riveFile.viewmodels)
+    {
+        const auto& viewModel = *viewModelPtr;
+        beginItem(first);
+        write("        ");
+        writeString(toCamelCase(viewModel.name));
+        write(": {\n");
+        writeField("          ", "\"name\": ", viewModel.name);
+        write("          \"properties\": {\n");
+        bool firstProperty = true;
+        for (const auto& property : viewModel.properties)
+        {
+            beginItem(firstProperty);
+            write("            ");
+            writeString(toCamelCase(property.name));
+            write(": {\n");
+            writeField("              ", "\"name\": ", property.name);
+            writeField("              ", "\"type\": ", property.type, true);
+            write("            }");
+        }
+        endList(firstProperty, "            ");
+        write("          }\n");
+        write("        }");
+    }
+    endList(first, "        ");
+    write("      },\n");
+
+    write("      \"artboards\": {\n");
+    first = true;
+    for (const auto& artboard : riveFile.artboards)
+    {
+        beginItem(first);
+        writeArtboard(*artboard);
+        flushIfFull();
+    }
+    endList(first, "        ");
+    write("      }\n");
+    write("    }");
+
+    flushIfFull();
+}
+
+void JsonGenerator::writeArtboard(const ArtboardData& artboard)
+{
+    write("        ");
+    writeString(artboard.artboardCameCase);
+    write(": {\n");
+    writeField("          ", "\"name\": ", artboard.artboardName);
+
+    write("          \"animations\": {\n");
+    bool first = true;
+    std::unordered_set<std::string> usedAnimationNames;
+    for (const auto& animation : artboard.animations)
+    {
+        beginItem(first);
+        write("            ");
+        writeString(toCamelCase(makeUnique(animation, usedAnimationNames)));
+        write(": ");
+        writeString(animation);
+    }
+    endList(first, "            ");
+    write("          },\n");
+
+    write("          \"textValueRuns\": {\n");
+    first = true;
+    std::unordered_set<std::string> usedTextValueRunNames;
+    for (const auto& textValueRun : artboard.textValueRuns)
+    {
+        beginItem(first);
+        write("            ");
+        writeString(
+            toCamelCase(makeUnique(textValueRun.name, usedTextValueRunNames)));
+        write(": ");
+        writeString(textValueRun.defaultValue);
+    }
+    endList(first, "            ");
+    write("          },\n");
+
+    write("          \"nestedTextValueRuns\": [\n");
+    first = true;
+    for (const auto& nestedTextValueRun : artboard.nestedTextValueRuns)
+    {
+        beginItem(first);
+        write("            {\n");
+        writeField("              ", "\"name\": ", nestedTextValueRun.name);
+        writeField("              ",
+                   "\"path\": ",
+                   nestedTextValueRun.path,
+                   true);
+        write("            }");
+    }
+    endList(first, "            ");
+    write("          ],\n");
+
+    write("          \"stateMachines\": {\n");
+    first = true;
+    std::unordered_set<std::string> usedStateMachineNames;
+    for (const auto& stateMachine : artboard.stateMachines)
+    {
+        beginItem(first);
+        write("            ");
+        writeString(toCamelCase(
+            makeUnique(stateMachine.first, usedStateMachineNames)));
+        write(": {\n");
+        writeField("              ", "\"name\": ", stateMachine.first);
+        write("              \"inputs\": {\n");
+        bool firstInput = true;
+        std::unordered_set<std::string> usedInputNames;
+        for (const auto& input : stateMachine.second)
+        {
+            beginItem(firstInput);
+            write("                ");
+            writeString(toCamelCase(makeUnique(input.name, usedInputNames)));
+            write(": {\n");
+            writeField("                  ", "\"name\": ", input.name);
+            writeField("                  ", "\"type\": ", input.type);
+            writeField("                  ",
+                       "\"defaultValue\": ",
+                       input.defaultValue,
+                       true);
+            write("                }");
+        }
+        endList(firstInput, "                ");
+        write("              }\n");
+        write("            }");
+    }
+    endList(first, "            ");
+    write("          }\n");
+    write("        }");
+}
+
+void JsonGenerator::finish()
+{
+    endList(m_firstFile, "    ");
+    write("  }\n}");
+    m_output.write(m_buffer.data(), m_buffer.size());
+    m_buffer.clear();
+    m_output.flush();
+}
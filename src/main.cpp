@@ -1,686 +1,802 @@
+#include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <optional>
+#include <set>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
 #include "CLIUTILS/CLI11.hpp"
+#include "bounded_queue.h"
+#include "builtin_templates.h"
+#include "cpp_generator.h"
 #include "default_template.h"
+#include "extraction_stages.h"
+#include "isolated_extractor.h"
+#include "json_generator.h"
 #include "kainjow/mustache.hpp"
-#include "rive/animation/linear_animation_instance.hpp"
-#include "rive/animation/state_machine_input_instance.hpp"
-#include "rive/animation/state_machine_instance.hpp"
-#include "rive/assets/audio_asset.hpp"
-#include "rive/assets/font_asset.hpp"
-#include "rive/assets/image_asset.hpp"
-#include "rive/file.hpp"
-#include "rive/generated/animation/state_machine_bool_base.hpp"
-#include "rive/generated/animation/state_machine_number_base.hpp"
-#include "rive/generated/animation/state_machine_trigger_base.hpp"
-#include "rive/viewmodel/data_enum.hpp"
-#include "rive/viewmodel/data_enum_value.hpp"
-#include "rive/viewmodel/runtime/viewmodel_runtime.hpp"
-#include "rive/viewmodel/viewmodel_property_enum.hpp"
-#include "utils/no_op_factory.hpp"
-
-const std::string generatedFileName = "rive_generated";
-
-enum class CaseStyle
-{
-    Camel,
-    Pascal,
-    Snake,
-    Kebab,
-};
+#include "parallel_for.h"
+#include "partial_results.h"
+#include "rive_diff.h"
+#include "rive_extractor.h"
+#include "rive_file_data.h"
+#include "rive_input.h"
+#include "structure_interner.h"
+#include "template_data.h"
+#include "template_profiler.h"
+#include "template_render.h"
+#include "template_split.h"
 
 enum class Language
 {
     Dart,
-    JavaScript
+    JavaScript,
+    Cpp,
+    Json
 };
 
-struct InputInfo
-{
-    std::string name;
-    std::string type;
-    std::string defaultValue;
-};
-
-struct TextValueRunInfo
-{
-    std::string name;
-    std::string defaultValue;
-};
-
-struct NestedTextValueRunInfo
-{
-    std::string name;
-    std::string path;
-};
-
-struct AssetInfo
-{
-    std::string name;
-    std::string type;
-    std::string fileExtension;
-    std::string assetId;
-    std::string cdnUuid;
-    std::string cdnBaseUrl;
-};
-
-struct EnumValueInfo
-{
-    std::string key;
-};
-
-struct EnumInfo
-{
-    std::string name;
-    std::vector<EnumValueInfo> values;
-};
-
-struct PropertyInfo
+static std::vector<std::string> findRiveFiles(const std::string& path)
 {
-    std::string name;
-    std::string type;
-    std::string backingName;
-};
+    std::vector<std::string> riveFile;
 
-struct ViewModelInfo
-{
-    std::string name;
-    std::vector<PropertyInfo> properties;
-};
+    if (std::filesystem::is_directory(path))
+    {
+        for (const auto& entry : std::filesystem::directory_iterator(path))
+        {
+            if (entry.path().extension() == ".riv")
+            {
+                riveFile.push_back(entry.path().string());
+            }
+        }
+    }
+    else if (std::filesystem::path(path).extension() == ".riv")
+    {
+        riveFile.push_back(path);
+    }
 
-struct ArtboardData
-{
-    std::string artboardName;
-    std::string artboardPascalCase;
-    std::string artboardCameCase;
-    std::string artboardSnakeCase;
-    std::string artboardKebabCase;
-    std::vector<std::string> animations;
-    std::vector<std::pair<std::string, std::vector<InputInfo>>> stateMachines;
-    std::vector<TextValueRunInfo> textValueRuns;
-    std::vector<NestedTextValueRunInfo> nestedTextValueRuns;
-};
+    // Directory order is unspecified, and the output should be the same on
+    // every machine
+    std::sort(riveFile.begin(), riveFile.end());
+    return riveFile;
+}
 
-struct RiveFileData
+// Extracts the files on a thread per core, keeping their order. Failed
+// files are nullopt, with the error already printed.
+static std::vector<std::optional<RiveFileData>> processRiveFilesInParallel(
+    const std::vector<std::string>& riveFiles,
+    StructureInterner& interner,
+    const ExtractionStages& stages)
 {
-    std::string rivPascalCase;
-    std::string rivCameCase;
-    std::string riveSnakeCase;
-    std::string rivKebabCase;
-    std::vector<ArtboardData> artboards;
-    std::vector<AssetInfo> assets;
-    std::vector<EnumInfo> enums;
-    std::vector<ViewModelInfo> viewmodels;
-};
+    std::vector<std::optional<RiveFileData>> results(riveFiles.size());
+    parallelFor(riveFiles.size(),
+                [&](size_t i)
+                {
+                    results[i] =
+                        processRiveFile(riveFiles[i], interner, stages);
+                });
+    return results;
+}
 
-// Helper function to convert a string to the specified case style
-static std::string toCaseHelper(const std::string& str, CaseStyle style)
+// How many archive entries are read ahead of the one being extracted
+static constexpr size_t archivePrefetchEntries = 2;
+
+// Extracts each input file in order, passing the ones that could be read to
+// onFile. Files on disk are `riveFiles`, extracted in worker processes if
+// `isolation` is set; stdin and tar archives are read from `inputPath`, with
+// archive entries read on a second thread while the previous one is
+// extracted. Structures are interned with `interner`, or only within each
+// file if it's null. Returns false if the input couldn't be read, with the
+// error already printed.
+template <typename OnFile>
+static bool extractRiveFiles(const std::string& inputPath,
+                             const std::vector<std::string>& riveFiles,
+                             const ExtractionStages& stages,
+                             const IsolationLimits* isolation,
+                             StructureInterner* interner,
+                             const OnFile& onFile)
 {
-    std::stringstream result;
-    bool capitalizeNext = (style == CaseStyle::Pascal);
-    bool firstChar = true;
-
-    // Check if the first character is a digit
-    if (std::isdigit(str[0]))
+    const auto extract = [&](const auto& process)
+    {
+        StructureInterner ownInterner;
+        auto result = process(interner ? *interner : ownInterner);
+        if (result)
+        {
+            onFile(std::move(*result));
+        }
+        // If result is nullopt, the error has already been printed
+    };
+    const auto extractInput = [&](const RiveInput& input)
     {
-        result << 'n';         // Prepend 'n' for number
-        capitalizeNext = true; // Capitalize the first digit
-        firstChar = false;
+        extract(
+            [&](StructureInterner& fileInterner)
+            {
+                return processRiveBytes(input.path,
+                                        input.bytes.data(),
+                                        input.bytes.size(),
+                                        fileInterner,
+                                        stages);
+            });
+    };
+
+    if (isStdinPath(inputPath))
+    {
+        auto input = readStdin();
+        if (!input)
+        {
+            return false;
+        }
+        extractInput(*input);
+        return true;
     }
 
-    // Process the string
-    for (size_t i = 0; i < str.length(); i++)
+    if (isTarPath(inputPath))
     {
-        char c = str[i];
-
-        if (std::isalnum(c))
+        std::ifstream archive(inputPath, std::ios::binary);
+        if (!archive.is_open())
         {
-            if (capitalizeNext)
-            {
-                result << (char)std::toupper(c);
-                capitalizeNext = false;
-            }
-            else
+            std::cerr << "Error: Unable to open archive: " << inputPath
+                      << std::endl;
+            return false;
+        }
+        BoundedQueue<RiveInput> entries(archivePrefetchEntries);
+        bool archiveRead = false;
+        size_t entryCount = 0;
+        std::thread reader(
+            [&]()
             {
-                result << (style == CaseStyle::Pascal ? c
-                                                      : (char)std::tolower(c));
-            }
-            firstChar = false;
+                archiveRead = readTarArchive(archive,
+                                             inputPath,
+                                             [&](RiveInput&& entry)
+                                             {
+                                                 entryCount++;
+                                                 entries.push(
+                                                     std::move(entry));
+                                             });
+                entries.close();
+            });
+        while (auto entry = entries.pop())
+        {
+            extractInput(*entry);
         }
-        else if (c == ' ' || c == '_' || c == '-')
+        reader.join();
+        if (archiveRead && entryCount == 0)
         {
-            if (!firstChar)
-            {
-                switch (style)
-                {
-                    case CaseStyle::Camel:
-                    case CaseStyle::Pascal:
-                        capitalizeNext = true;
-                        break;
-                    case CaseStyle::Snake:
-                        result << '_';
-                        break;
-                    case CaseStyle::Kebab:
-                        result << '-';
-                        break;
-                }
-            }
+            std::cerr << "No .riv files found in the specified path."
+                      << std::endl;
+            return false;
         }
-        // All other characters are ignored
+        return archiveRead;
     }
 
-    // Ensure the result is not empty and starts with a letter
-    std::string finalResult = result.str();
-    if (finalResult.empty() || !std::isalpha(finalResult[0]))
+    if (isolation)
     {
-        finalResult = "X" + finalResult;
+        return extractRiveFilesIsolated(riveFiles,
+                                        stages,
+                                        *isolation,
+                                        interner,
+                                        [&](size_t, RiveFileData&& fileData)
+                                        { onFile(std::move(fileData)); });
     }
-
-    return finalResult;
-}
-
-static std::string toCamelCase(const std::string& str)
-{
-    std::string result = toCaseHelper(str, CaseStyle::Camel);
-    // TODO: These handlers are generic to dart, we need to make something more
-    // generic to handle all languages
-    // Handle Dart reserved keywords
-    if (result == "with" || result == "class" || result == "enum" ||
-        result == "var" || result == "const" || result == "final" ||
-        result == "static" || result == "void" || result == "int" ||
-        result == "double" || result == "bool" || result == "String" ||
-        result == "List" || result == "Map" || result == "dynamic" ||
-        result == "null" || result == "true" || result == "false")
-    {
-        result = result + "Value";
-    }
-    return result;
-}
-
-static std::string toPascalCase(const std::string& str)
-{
-    return toCaseHelper(str, CaseStyle::Pascal);
+    for (const auto& riv_file : riveFiles)
+    {
+        extract([&](StructureInterner& fileInterner)
+                { return processRiveFile(riv_file, fileInterner, stages); });
+    }
+    return true;
 }
 
-static std::string toSnakeCase(const std::string& str)
+// Prints the changes between two Rive files, or between the files of two
+// directories matched by name, one JSON object per line. Only the parts in
+// `stages` are compared.
+static int diffRivePaths(const std::string& beforePath,
+                         const std::string& afterPath,
+                         const ExtractionStages& stages)
 {
-    return toCaseHelper(str, CaseStyle::Snake);
-}
+    std::vector<std::string> beforeFiles = findRiveFiles(beforePath);
+    std::vector<std::string> afterFiles = findRiveFiles(afterPath);
+    if ((beforeFiles.empty() && !std::filesystem::is_directory(beforePath)) ||
+        (afterFiles.empty() && !std::filesystem::is_directory(afterPath)))
+    {
+        std::cerr << "Error: --diff needs two .riv files or directories"
+                  << std::endl;
+        return 1;
+    }
+    // Both sides share an interner, so the structures that didn't change
+    // are the same objects and are skipped without comparing their contents
+    std::vector<std::string> allFiles = beforeFiles;
+    allFiles.insert(allFiles.end(), afterFiles.begin(), afterFiles.end());
+    StructureInterner interner;
+    auto results = processRiveFilesInParallel(allFiles, interner, stages);
+
+    std::vector<RiveFileData> before;
+    std::vector<RiveFileData> after;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        if (results[i])
+        {
+            auto& side = i < beforeFiles.size() ? before : after;
+            side.push_back(std::move(*results[i]));
+        }
+        // If the result is nullopt, the error has already been printed
+    }
 
-static std::string toKebabCase(const std::string& str)
-{
-    return toCaseHelper(str, CaseStyle::Kebab);
+    bool comparingFiles = !std::filesystem::is_directory(beforePath) &&
+                          !std::filesystem::is_directory(afterPath);
+    if (comparingFiles && (before.empty() || after.empty()))
+    {
+        return 1;
+    }
+    writeChanges(std::cout,
+                 comparingFiles ? diffRiveFile(before[0], after[0])
+                                : diffRiveFiles(before, after));
+    return 0;
 }
 
-static std::string sanitizeString(const std::string& input)
+// Parses a string of digits, or nullopt if it doesn't fit in 32 bits
+static std::optional<uint32_t> parseUint32(const std::string& digits)
 {
-    std::string output;
-    for (char c : input)
+    errno = 0;
+    unsigned long long value = std::strtoull(digits.c_str(), nullptr, 10);
+    if (errno == ERANGE || value > UINT32_MAX)
     {
-        switch (c)
-        {
-            case '\n':
-                output += "\\n";
-                break;
-            case '\r':
-                output += "\\r";
-                break;
-            case '\t':
-                output += "\\t";
-                break;
-            case '\"':
-                output += "\\\"";
-                break;
-            case '\\':
-                output += "\\\\";
-                break;
-            default:
-                if (std::isprint(c))
-                {
-                    output += c;
-                }
-                else
-                {
-                    char hex[7];
-                    std::snprintf(hex,
-                                  sizeof(hex),
-                                  "\\u%04x",
-                                  static_cast<unsigned char>(c));
-                    output += hex;
-                }
-        }
+        return std::nullopt;
     }
-    return output;
+    return static_cast<uint32_t>(value);
 }
 
-static std::unique_ptr<rive::File> openFile(const char name[])
+// Parses "i/N" into a shard index and count
+static bool parseShard(const std::string& spec,
+                       uint32_t& index,
+                       uint32_t& count)
 {
-    FILE* f = fopen(name, "rb");
-    if (!f)
+    size_t slash = spec.find('/');
+    if (slash == std::string::npos || slash == 0 || slash + 1 == spec.size() ||
+        spec.find_first_not_of("0123456789/") != std::string::npos ||
+        spec.find('/', slash + 1) != std::string::npos)
     {
-        return nullptr;
+        return false;
     }
-
-    fseek(f, 0, SEEK_END);
-    auto length = ftell(f);
-    fseek(f, 0, SEEK_SET);
-
-    std::vector<uint8_t> bytes(length);
-
-    if (fread(bytes.data(), 1, length, f) != length)
+    std::optional<uint32_t> parsedIndex = parseUint32(spec.substr(0, slash));
+    std::optional<uint32_t> parsedCount = parseUint32(spec.substr(slash + 1));
+    if (!parsedIndex || !parsedCount)
     {
-        printf("Failed to read file into bytes array\n");
-        return nullptr;
+        return false;
     }
-
-    static rive::NoOpFactory gFactory;
-    return rive::File::import(bytes, &gFactory);
+    index = *parsedIndex;
+    count = *parsedCount;
+    return count > 0 && index < count;
 }
 
-static std::vector<std::string> getAnimationsFromArtboard(
-    rive::ArtboardInstance* artboard)
+// Where a file was found relative to the input, which is the same on every
+// machine
+static std::string relativeRivePath(const std::string& inputPath,
+                                    const std::string& riveFile)
 {
-    std::vector<std::string> animations;
-    auto animationCount = artboard->animationCount();
-    for (int i = 0; i < animationCount; i++)
+    std::filesystem::path path(riveFile);
+    if (std::filesystem::is_directory(inputPath))
     {
-        auto animation = artboard->animationAt(i);
-        animations.push_back(animation->name());
+        return path.lexically_relative(inputPath).generic_string();
     }
-    return animations;
+    return path.filename().generic_string();
 }
 
-static std::vector<std::pair<std::string, std::vector<InputInfo>>>
-getStateMachinesFromArtboard(rive::ArtboardInstance* artboard)
+static std::optional<std::string> readBinaryFile(const std::string& path)
 {
-    std::vector<std::pair<std::string, std::vector<InputInfo>>> stateMachines;
-    auto stateMachineCount = artboard->stateMachineCount();
-    for (int i = 0; i < stateMachineCount; i++)
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
     {
-        auto stateMachine = artboard->stateMachineAt(i);
-        std::string stateMachineName = stateMachine->name();
+        std::cerr << "Error: Unable to open file: " << path << std::endl;
+        return std::nullopt;
+    }
+    return std::string(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+}
 
-        std::vector<InputInfo> inputs;
-        auto inputCount = stateMachine->inputCount();
-        for (int j = 0; j < inputCount; j++)
+// Combines the files of every shard's partial results in the order a single
+// run would have extracted them. Every shard must be there, extracted with
+// at least `stages`.
+static bool mergePartialResults(const std::vector<std::string>& partialPaths,
+                                const ExtractionStages& stages,
+                                StructureInterner& interner,
+                                std::vector<RiveFileData>& riveFileDataList)
+{
+    std::vector<PartialResults::File> files;
+    // The count comes from the files, so the shards seen are kept as a set
+    // rather than a flag per shard
+    uint32_t shardCount = 0;
+    std::set<uint32_t> shardsSeen;
+    for (const auto& partialPath : partialPaths)
+    {
+        auto bytes = readBinaryFile(partialPath);
+        if (!bytes)
         {
-            auto input = stateMachine->input(j);
-
-            std::string inputType;
-            std::string defaultValue;
+            return false;
+        }
+        auto partial =
+            deserializePartialResults(*bytes, partialPath, interner);
+        if (!partial)
+        {
+            return false;
+        }
 
-            // Determine the input type and default value
-            switch (input->inputCoreType())
-            {
-                case rive::StateMachineNumberBase::typeKey:
-                {
-                    auto smiNumberInput = static_cast<rive::SMINumber*>(input);
-                    inputType = "number";
-                    defaultValue = std::to_string(smiNumberInput->value());
-                    break;
-                }
-                case rive::StateMachineTriggerBase::typeKey:
-                {
-                    inputType = "trigger";
-                    defaultValue = "false";
-                    break;
-                }
-                case rive::StateMachineBoolBase::typeKey:
-                {
-                    auto smiBoolInput = static_cast<rive::SMIBool*>(input);
-                    inputType = "boolean";
-                    defaultValue = smiBoolInput->value() ? "true" : "false";
-                    break;
-                }
-                default:
-                {
-                    inputType = "unknown";
-                    defaultValue = "";
-                    break;
-                }
-            }
+        if (shardCount == 0)
+        {
+            shardCount = partial->shardCount;
+        }
+        if (partial->shardCount != shardCount ||
+            !shardsSeen.insert(partial->shardIndex).second)
+        {
+            std::cerr << "Error: Partial results file " << partialPath
+                      << " is shard " << partial->shardIndex << "/"
+                      << partial->shardCount
+                      << ", which doesn't fit with the other shards"
+                      << std::endl;
+            return false;
+        }
 
-            inputs.push_back({input->name(), inputType, defaultValue});
+        uint32_t missingStages =
+            stagesToBits(stages) & ~stagesToBits(partial->stages);
+        if (missingStages != 0)
+        {
+            std::cerr << "Error: Partial results file " << partialPath
+                      << " doesn't have everything the output uses. Run "
+                         "--shard with the same template, language or --only."
+                      << std::endl;
+            return false;
         }
 
-        stateMachines.emplace_back(stateMachineName, inputs);
+        std::move(partial->files.begin(),
+                  partial->files.end(),
+                  std::back_inserter(files));
     }
-    return stateMachines;
-}
-
-static std::vector<std::string> findRiveFiles(const std::string& path)
-{
-    std::vector<std::string> riveFile;
 
-    if (std::filesystem::is_directory(path))
+    if (shardsSeen.size() != shardCount)
     {
-        for (const auto& entry : std::filesystem::directory_iterator(path))
-        {
-            if (entry.path().extension() == ".riv")
-            {
-                riveFile.push_back(entry.path().string());
-            }
-        }
+        std::cerr << "Error: Only " << shardsSeen.size() << " of "
+                  << shardCount << " shards were given to --merge"
+                  << std::endl;
+        return false;
     }
-    else if (std::filesystem::path(path).extension() == ".riv")
+
+    std::stable_sort(files.begin(),
+                     files.end(),
+                     [](const auto& a, const auto& b)
+                     { return a.relativePath < b.relativePath; });
+    riveFileDataList.reserve(files.size());
+    for (auto& file : files)
     {
-        riveFile.push_back(path);
+        riveFileDataList.push_back(std::move(file.data));
     }
-
-    return riveFile;
+    return true;
 }
 
-static std::string makeUnique(const std::string& base,
-                       std::unordered_set<std::string>& usedNames)
+static std::optional<std::string> readTemplateFile(const std::string& path)
 {
-    std::string uniqueName = base;
-    int counter = 1;
-    while (usedNames.find(uniqueName) != usedNames.end())
+    std::ifstream file(path);
+    if (!file.is_open())
     {
-        uniqueName = base + "U" + std::to_string(counter);
-        counter++;
+        std::cerr << "Warning: Unable to open template file: " << path
+                  << std::endl;
+        return std::nullopt;
     }
-    usedNames.insert(uniqueName);
-    return uniqueName;
+    return std::string(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
 }
 
-template <typename T = rive::Component>
-void findAll(std::vector<T*>& results, rive::ArtboardInstance* artboard)
+// Size of the chunks outputs are compared in, so that existing files are
+// never held in memory as a whole
+static constexpr size_t compareChunkSize = 64 * 1024;
+
+// Returns true if the file at `path` holds exactly `content`, comparing the
+// bytes themselves once the sizes match
+static bool fileContentMatches(const std::filesystem::path& path,
+                               const std::string& content)
 {
-    for (auto object : artboard->objects())
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(path, ec) ||
+        std::filesystem::file_size(path, ec) != content.size() || ec)
+    {
+        return false;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
     {
-        if (object != nullptr && object->is<T>())
+        return false;
+    }
+    std::vector<char> buffer(compareChunkSize);
+    for (size_t offset = 0; offset < content.size();
+         offset += compareChunkSize)
+    {
+        size_t chunk = std::min(compareChunkSize, content.size() - offset);
+        if (!file.read(buffer.data(), chunk) ||
+            std::memcmp(buffer.data(), content.data() + offset, chunk) != 0)
         {
-            results.push_back(static_cast<T*>(object));
+            return false;
         }
     }
+    return true;
 }
 
-static std::vector<TextValueRunInfo> getTextValueRunsFromArtboard(
-    rive::ArtboardInstance* artboard)
+// Returns true if the files at `a` and `b` hold the same bytes
+static bool filesMatch(const std::filesystem::path& a,
+                       const std::filesystem::path& b)
 {
-    std::vector<rive::TextValueRun*> textValueRuns;
-    std::vector<TextValueRunInfo> textValueRunsInfo;
-
-    findAll<rive::TextValueRun>(textValueRuns, artboard);
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(a, ec) ||
+        !std::filesystem::is_regular_file(b, ec) ||
+        std::filesystem::file_size(a, ec) !=
+            std::filesystem::file_size(b, ec) ||
+        ec)
+    {
+        return false;
+    }
 
-    for (auto textValueRun : textValueRuns)
+    std::ifstream fileA(a, std::ios::binary);
+    std::ifstream fileB(b, std::ios::binary);
+    if (!fileA.is_open() || !fileB.is_open())
+    {
+        return false;
+    }
+    std::vector<char> bufferA(compareChunkSize);
+    std::vector<char> bufferB(compareChunkSize);
+    while (fileA && fileB)
     {
-        if (!textValueRun->name().empty())
+        fileA.read(bufferA.data(), compareChunkSize);
+        fileB.read(bufferB.data(), compareChunkSize);
+        if (fileA.gcount() != fileB.gcount() ||
+            std::memcmp(bufferA.data(), bufferB.data(), fileA.gcount()) != 0)
         {
-            textValueRunsInfo.push_back(
-                {textValueRun->name(), textValueRun->text()});
+            return false;
         }
     }
-    return textValueRunsInfo;
+    return !fileA.bad() && !fileB.bad();
 }
 
-static std::vector<NestedTextValueRunInfo>
-getNestedTextValueRunPathsFromArtboard(
-    rive::ArtboardInstance* artboard,
-    const std::string& currentPath = "")
+// Outputs are written to a temporary file next to the destination first,
+// named after this process so that concurrent runs writing the same output
+// don't write into each other's temporary files
+static std::filesystem::path temporaryPathFor(const std::filesystem::path& path)
 {
-    std::vector<NestedTextValueRunInfo> nestedTextValueRunsInfo;
-    auto count = artboard->nestedArtboards().size();
+    std::filesystem::path tempPath = path;
+    tempPath += "." + std::to_string(getpid()) + ".tmp";
+    return tempPath;
+}
 
-    if (!currentPath.empty())
+// Moves a fully written temporary file over `path`, unless `path` already
+// has identical content, in which case the temporary file is discarded so
+// that the unchanged output keeps its mtime and doesn't trigger downstream
+// rebuilds. The rename is atomic, so readers never observe a partially
+// written file. Returns false on error.
+static bool commitFileIfChanged(const std::filesystem::path& tempPath,
+                                const std::filesystem::path& path,
+                                bool& changed)
+{
+    changed = false;
+    std::error_code ec;
+    if (filesMatch(path, tempPath))
     {
-        auto textRuns = getTextValueRunsFromArtboard(artboard);
-        for (const auto& textRun : textRuns)
-        {
-            nestedTextValueRunsInfo.push_back(
-                {textRun.name, currentPath});
-        }
+        std::filesystem::remove(tempPath, ec);
+        return true;
     }
 
-    // Recursively process nested artboards
-    for (int i = 0; i < count; i++)
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec)
     {
-        auto nested = artboard->nestedArtboards()[i];
-        auto nestedName = nested->name();
-        if (!nestedName.empty())
-        {
-            // Only process nested artboards that have an exported name
-            std::string newPath = currentPath.empty()
-                                       ? nested->name()
-                                       : currentPath + "/" + nested->name();
-
-            auto nestedResults = getNestedTextValueRunPathsFromArtboard(
-                nested->artboardInstance(),
-                newPath);
-            nestedTextValueRunsInfo.insert(
-                nestedTextValueRunsInfo.end(),
-                nestedResults.begin(),
-                nestedResults.end());
-        }
+        std::cerr << "Error: Unable to replace output file: " << path << " ("
+                  << ec.message() << ")" << std::endl;
+        std::filesystem::remove(tempPath, ec);
+        return false;
     }
 
-    return nestedTextValueRunsInfo;
+    changed = true;
+    return true;
 }
 
-static std::vector<AssetInfo> getAssetsFromFile(rive::File* file)
+// Writes `content` to `path` unless the file already has identical content.
+// See commitFileIfChanged().
+static bool writeFileIfChanged(const std::filesystem::path& path,
+                               const std::string& content,
+                               bool& changed)
 {
-    std::vector<AssetInfo> assetsInfo;
-    std::unordered_set<std::string> usedAssetNames;
+    changed = false;
+    if (fileContentMatches(path, content))
+    {
+        return true;
+    }
+
+    std::filesystem::path tempPath = temporaryPathFor(path);
+    std::ofstream tempFile(tempPath, std::ios::binary | std::ios::trunc);
+    if (!tempFile.is_open())
+    {
+        std::cerr << "Error: Unable to open output file: " << tempPath
+                  << std::endl;
+        return false;
+    }
+    tempFile << content;
+    tempFile.close();
+    if (!tempFile)
+    {
+        std::cerr << "Error: Failed to write output file: " << tempPath
+                  << std::endl;
+        std::filesystem::remove(tempPath);
+        return false;
+    }
+
+    return commitFileIfChanged(tempPath, path, changed);
+}
 
-    auto assets = file->assets();
-    for (auto asset : assets)
+// Escapes a path for use in a Make-format dependency file
+static std::string escapeDepfilePath(const std::string& path)
+{
+    std::string escaped;
+    escaped.reserve(path.size());
+    for (char c : path)
     {
-        std::string assetType;
-        switch (asset->coreType())
+        switch (c)
         {
-            case rive::ImageAsset::typeKey:
-                assetType = "image";
-                break;
-            case rive::FontAsset::typeKey:
-                assetType = "font";
+            case ' ':
+            case '#':
+                escaped += '\\';
+                escaped += c;
                 break;
-            case rive::AudioAsset::typeKey:
-                assetType = "audio";
+            case '$':
+                escaped += "$$";
                 break;
             default:
-                assetType = "unknown";
-                break;
+                escaped += c;
         }
+    }
+    return escaped;
+}
 
-        auto assetName = asset->name();
-        auto uniqueAssetName = makeUnique(assetName, usedAssetNames);
-
-        assetsInfo.push_back(AssetInfo{uniqueAssetName,
-                                       assetType,
-                                       asset->fileExtension(),
-                                       std::to_string(asset->assetId()),
-                                       asset->cdnUuidStr(),
-                                       asset->cdnBaseUrl()});
+// Builds a Make-format dependency file (understood by both Make and Ninja)
+// declaring that `target` depends on every input in `dependencies`
+static std::string makeDepfile(const std::string& target,
+                               const std::vector<std::string>& dependencies)
+{
+    std::string depfile = escapeDepfilePath(target) + ":";
+    for (const auto& dependency : dependencies)
+    {
+        depfile += " \\\n  ";
+        depfile += escapeDepfilePath(dependency);
     }
-    return assetsInfo;
+    depfile += "\n";
+    return depfile;
 }
 
-static std::string dataTypeToString(rive::DataType type)
+
+// Extracts the files of one shard and writes them as partial results
+static bool generatePartialResults(const std::string& inputPath,
+                                   const std::vector<std::string>& riveFiles,
+                                   uint32_t shardIndex,
+                                   uint32_t shardCount,
+                                   const ExtractionStages& stages,
+                                   const IsolationLimits* isolation,
+                                   const std::filesystem::path& outputPath,
+                                   bool& changed)
 {
-    switch (type)
-    {
-        case rive::DataType::none:
-            return "none";
-        case rive::DataType::string:
-            return "string";
-        case rive::DataType::number:
-            return "number";
-        case rive::DataType::boolean:
-            return "boolean";
-        case rive::DataType::color:
-            return "color";
-        case rive::DataType::list:
-            return "list";
-        case rive::DataType::enumType:
-            return "enum";
-        case rive::DataType::trigger:
-            return "trigger";
-        case rive::DataType::viewModel:
-            return "viewModel";
-        case rive::DataType::integer:
-            return "integer";
-        case rive::DataType::symbolListIndex:
-            return "symbolListIndex";
-        case rive::DataType::assetImage:
-            return "assetImage";
-        default:
-            return "unknown";
+    StructureInterner interner;
+    std::vector<std::optional<RiveFileData>> results;
+    if (isolation)
+    {
+        results.resize(riveFiles.size());
+        if (!extractRiveFilesIsolated(riveFiles,
+                                      stages,
+                                      *isolation,
+                                      &interner,
+                                      [&](size_t i, RiveFileData&& fileData)
+                                      { results[i] = std::move(fileData); }))
+        {
+            return false;
+        }
     }
+    else
+    {
+        results = processRiveFilesInParallel(riveFiles, interner, stages);
+    }
+
+    PartialResults partial;
+    partial.shardIndex = shardIndex;
+    partial.shardCount = shardCount;
+    partial.stages = stages;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        if (results[i])
+        {
+            partial.files.push_back({relativeRivePath(inputPath, riveFiles[i]),
+                                     std::move(*results[i])});
+        }
+        // If the result is nullopt, the error has already been printed
+    }
+    return writeFileIfChanged(outputPath,
+                              serializePartialResults(partial),
+                              changed);
 }
 
-static std::optional<RiveFileData> processRiveFile(const std::string& riveFilePath)
+// Extracts and serializes one Rive file at a time straight to disk, so
+// memory use doesn't grow with the number of files
+static bool generateJsonFile(const std::string& inputPath,
+                             const std::vector<std::string>& riveFiles,
+                             const ExtractionStages& stages,
+                             const IsolationLimits* isolation,
+                             const std::filesystem::path& outputPath,
+                             bool& changed)
 {
-    // Check if the file is empty
-    if (std::filesystem::is_empty(riveFilePath))
+    std::filesystem::path tempPath = temporaryPathFor(outputPath);
+    std::ofstream tempFile(tempPath, std::ios::binary | std::ios::trunc);
+    if (!tempFile.is_open())
     {
-        std::cerr << "Error: Rive file is empty: " << riveFilePath
+        std::cerr << "Error: Unable to open output file: " << tempPath
                   << std::endl;
-        return std::nullopt;
+        return false;
     }
 
-    auto riveFile = openFile(riveFilePath.c_str());
-    if (!riveFile)
+    JsonGenerator json(tempFile);
+    // Structures are only shared within each file here, so that memory use
+    // stays flat
+    bool extracted = extractRiveFiles(inputPath,
+                                      riveFiles,
+                                      stages,
+                                      isolation,
+                                      nullptr,
+                                      [&](RiveFileData&& fileData)
+                                      { json.addFile(fileData); });
+    json.finish();
+
+    tempFile.close();
+    if (!extracted)
     {
-        std::cerr << "Error: Failed to parse Rive file: " << riveFilePath
+        std::filesystem::remove(tempPath);
+        return false;
+    }
+    if (!tempFile)
+    {
+        std::cerr << "Error: Failed to write output file: " << tempPath
                   << std::endl;
-        return std::nullopt;
+        std::filesystem::remove(tempPath);
+        return false;
     }
 
-    std::filesystem::path path(riveFilePath);
-    std::string fileNameWithoutExtension = path.stem().string();
-    std::vector<AssetInfo> assets = getAssetsFromFile(riveFile.get());
-    RiveFileData fileData;
-    fileData.rivPascalCase = toPascalCase(fileNameWithoutExtension);
-    fileData.rivCameCase = toCamelCase(fileNameWithoutExtension);
-    fileData.riveSnakeCase = toSnakeCase(fileNameWithoutExtension);
-    fileData.rivKebabCase = toKebabCase(fileNameWithoutExtension);
-    fileData.assets = assets;
+    return commitFileIfChanged(tempPath, outputPath, changed);
+}
 
-    // Process enums
-    const auto& fileEnums = riveFile->enums();
-    for (auto* dataEnum : fileEnums)
+// How many files are extracted ahead of the one being rendered when streaming
+static constexpr size_t streamPrefetchFiles = 2;
+
+// Extracts the files on a second thread and renders each one's items as soon
+// as it's extracted, so that only a few files are held in memory at a time.
+// The header and footer need the names of the files that could be read, so
+// the items are written to a temporary file until every file is done.
+static bool generateStreamedFile(const std::string& inputPath,
+                                 const std::vector<std::string>& riveFiles,
+                                 const ExtractionStages& stages,
+                                 const IsolationLimits* isolation,
+                                 const TemplateSplit& split,
+                                 const TemplateCases& cases,
+                                 const std::filesystem::path& outputPath,
+                                 bool& changed)
+{
+    std::filesystem::path itemsPath = outputPath;
+    itemsPath += ".items";
+    itemsPath = temporaryPathFor(itemsPath);
+    std::fstream itemsFile(itemsPath,
+                           std::ios::binary | std::ios::in | std::ios::out |
+                               std::ios::trunc);
+    if (!itemsFile.is_open())
     {
-        if (dataEnum)
-        {
-            EnumInfo enumInfo;
-            enumInfo.name = dataEnum->enumName();
-            const auto& values = dataEnum->values();
-            for (const auto* value : values)
-            {
-                enumInfo.values.push_back({value->key()});
-            }
-            fileData.enums.push_back(enumInfo);
-        }
+        std::cerr << "Error: Unable to open output file: " << itemsPath
+                  << std::endl;
+        return false;
     }
 
-    // Process view models
-    for (size_t i = 0; i < riveFile->viewModelCount(); i++)
+    BoundedQueue<RiveFileData> extracted(streamPrefetchFiles);
+    bool inputRead = false;
+    std::thread extractor(
+        [&]()
+        {
+            // Structures are only shared within each file here, so that
+            // memory use stays flat
+            const auto push = [&](RiveFileData&& fileData)
+            { extracted.push(std::move(fileData)); };
+            inputRead = extractRiveFiles(inputPath,
+                                         riveFiles,
+                                         stages,
+                                         isolation,
+                                         nullptr,
+                                         push);
+            extracted.close();
+        });
+
+    SplitRenderers renderers(split);
+    std::vector<kainjow::mustache::data> fileNames;
+    const auto renderItem = [&](const RiveFileData& fileData, bool last)
+    {
+        SharedStructures shared(cases);
+        shared.countFile(fileData);
+        itemsFile << renderers.item.render(
+            fileTemplateData(fileData, shared, last));
+        fileNames.push_back(fileNameTemplateData(fileData, last, cases));
+    };
+
+    // Whether a file is the last one is only known once the next one has
+    // been extracted, or the extractor is done
+    std::optional<RiveFileData> pending;
+    while (auto fileData = extracted.pop())
     {
-        auto viewModel = riveFile->viewModelByIndex(i);
-        if (viewModel)
+        if (pending)
         {
-            ViewModelInfo viewModelInfo;
-            viewModelInfo.name = viewModel->name();
-            auto propertiesData = viewModel->properties();
-            for (const auto& property : propertiesData)
-            {
-                if (property.type == rive::DataType::viewModel)
-                {
-                    // TODO: this is a hack
-                    auto nestedViewModel =
-                        viewModel->createInstance()->propertyViewModel(
-                            property.name);
-                    auto vm = nestedViewModel->instance()->viewModel();
-                    viewModelInfo.properties.push_back(
-                        {property.name,
-                         dataTypeToString(property.type),
-                         vm->name()});
-                }
-                else if (property.type == rive::DataType::enumType)
-                {
-                    // TODO: this is a hack
-                    auto vmi =
-                        riveFile->createViewModelInstance(viewModel->name());
-                    auto enum_instance =
-                        static_cast<rive::ViewModelInstanceEnum*>(
-                            vmi->propertyValue(property.name));
-                    auto enumProperty = enum_instance->viewModelProperty()
-                                            ->as<rive::ViewModelPropertyEnum>();
-                    auto enumName = enumProperty->dataEnum()->enumName();
-                    viewModelInfo.properties.push_back(
-                        {property.name,
-                         dataTypeToString(property.type),
-                         enumName});
-                }
-                else
-                {
-                    viewModelInfo.properties.push_back(
-                        {property.name, dataTypeToString(property.type)});
-                }
-            }
-            fileData.viewmodels.push_back(viewModelInfo);
+            renderItem(*pending, false);
         }
+        pending = std::move(fileData);
     }
-
-    std::unordered_set<std::string> usedArtboardNames;
-
-    auto artboardCount = riveFile->artboardCount();
-    for (int i = 0; i < artboardCount; i++)
+    if (pending)
     {
-        auto artboard = riveFile->artboardAt(i);
-        std::string artboardName = artboard->name();
-
-        std::string artboardPascalCase = toPascalCase(artboardName);
-        std::string artboardCameCase = toCamelCase(artboardName);
-        std::string artboardSnakeCase = toSnakeCase(artboardName);
-        std::string artboardKebabCase = toKebabCase(artboardName);
-
-        // Ensure unique artboard variable names
-        artboardCameCase =
-            makeUnique(artboardCameCase, usedArtboardNames);
+        renderItem(*pending, true);
+    }
+    else
+    {
+        itemsFile << renderers.empty;
+    }
+    extractor.join();
+    if (!inputRead)
+    {
+        itemsFile.close();
+        std::filesystem::remove(itemsPath);
+        return false;
+    }
 
-        std::vector<std::string> animations =
-            getAnimationsFromArtboard(artboard.get());
-        std::vector<std::pair<std::string, std::vector<InputInfo>>>
-            stateMachines = getStateMachinesFromArtboard(artboard.get());
-        std::vector<TextValueRunInfo> textValueRuns =
-            getTextValueRunsFromArtboard(artboard.get());
-        std::vector<NestedTextValueRunInfo> nestedTextValueRuns =
-            getNestedTextValueRunPathsFromArtboard(artboard.get());
+    kainjow::mustache::data indexData;
+    indexData["generated_file_name"] = generatedFileName;
+    indexData["riv_files"] = fileNames;
 
-        fileData.artboards.push_back({artboardName,
-                                       artboardPascalCase,
-                                       artboardCameCase,
-                                       artboardSnakeCase,
-                                       artboardKebabCase,
-                                       animations,
-                                       stateMachines,
-                                       textValueRuns,
-                                       nestedTextValueRuns});
+    std::filesystem::path tempPath = temporaryPathFor(outputPath);
+    std::ofstream tempFile(tempPath, std::ios::binary | std::ios::trunc);
+    if (!tempFile.is_open())
+    {
+        std::cerr << "Error: Unable to open output file: " << tempPath
+                  << std::endl;
+        std::filesystem::remove(itemsPath);
+        return false;
     }
+    tempFile << renderers.header.render(indexData);
+    itemsFile.seekg(0);
+    if (itemsFile.peek() != std::char_traits<char>::eof())
+    {
+        tempFile << itemsFile.rdbuf();
+    }
+    tempFile << renderers.footer.render(indexData);
+    bool itemsWritten = !itemsFile.fail();
+    itemsFile.close();
+    std::filesystem::remove(itemsPath);
 
-    return fileData;
-}
-
-static std::optional<std::string> readTemplateFile(const std::string& path)
-{
-    std::ifstream file(path);
-    if (!file.is_open())
+    tempFile.close();
+    if (!tempFile || !itemsWritten)
     {
-        std::cerr << "Warning: Unable to open template file: " << path
+        std::cerr << "Error: Failed to write output file: " << tempPath
                   << std::endl;
-        return std::nullopt;
+        std::filesystem::remove(tempPath);
+        return false;
     }
-    return std::string(std::istreambuf_iterator<char>(file),
-                       std::istreambuf_iterator<char>());
+
+    return commitFileIfChanged(tempPath, outputPath, changed);
 }
 
 int main(int argc, char* argv[])
@@ -690,16 +806,31 @@ int main(int argc, char* argv[])
     std::string inputPath;
     std::string outputFilePath;
     std::string templatePath;
+    std::string depfilePath;
+    bool stream = false;
+    bool profileTemplate = false;
     Language language = Language::Dart; // Default to Dart
 
+    std::vector<std::string> diffPaths;
+    std::vector<std::string> onlyStages;
+    std::string shardSpec;
+    std::vector<std::string> mergePaths;
+    bool isolate = false;
+    unsigned int isolateTimeout = 60;
+    uint64_t isolateMemory = 0;
+
     app.add_option("-i, --input",
                    inputPath,
-                   "Path to Rive file or directory containing Rive files")
-        ->required()
-        ->check(CLI::ExistingFile | CLI::ExistingDirectory);
+                   "Path to Rive file, directory containing Rive files, "
+                   "tar archive of Rive files, or - to read a Rive file "
+                   "from stdin")
+        ->check(CLI::ExistingFile | CLI::ExistingDirectory |
+                CLI::Validator(
+                    [](std::string& path)
+                    { return isStdinPath(path) ? "" : "Not stdin: " + path; },
+                    "-"));
 
-    app.add_option("-o, --output", outputFilePath, "Output file path")
-        ->required();
+    app.add_option("-o, --output", outputFilePath, "Output file path");
 
     app.add_option("-t,--template", templatePath, "Custom template file path");
 
@@ -708,18 +839,127 @@ int main(int argc, char* argv[])
                    "Programming language for code generation")
         ->transform(CLI::CheckedTransformer(
             std::map<std::string, Language>{{"dart", Language::Dart},
-                                            {"js", Language::JavaScript}},
+                                            {"js", Language::JavaScript},
+                                            {"cpp", Language::Cpp},
+                                            {"json", Language::Json}},
             CLI::ignore_case));
 
+    app.add_option("--depfile",
+                   depfilePath,
+                   "Make-format dependency file output path");
+
+    app.add_flag("--stream",
+                 stream,
+                 "Render each file as it is read to bound memory use");
+
+    app.add_flag("--profile-template",
+                 profileTemplate,
+                 "Print where rendering the template went, by section and "
+                 "line");
+
+    app.add_option("--diff",
+                   diffPaths,
+                   "Print the changes between two Rive files or directories "
+                   "instead of generating code")
+        ->expected(2)
+        ->check(CLI::ExistingFile | CLI::ExistingDirectory);
+
+    app.add_option("--only",
+                   onlyStages,
+                   "Extract only these parts of the files, instead of what "
+                   "the output uses")
+        ->delimiter(',')
+        ->check(CLI::IsMember(extractionStageNames()));
+
+    app.add_option("--shard",
+                   shardSpec,
+                   "Extract only shard i/N of the input files and write them "
+                   "to the output as partial results for --merge")
+        ->check(CLI::Validator(
+            [](std::string& spec)
+            {
+                uint32_t index, count;
+                return parseShard(spec, index, count)
+                           ? ""
+                           : "Not a shard of the form i/N: " + spec;
+            },
+            "i/N"));
+
+    app.add_option("--merge",
+                   mergePaths,
+                   "Generate code from the partial results of every shard "
+                   "instead of --input")
+        ->check(CLI::ExistingFile);
+
+    auto* isolateFlag =
+        app.add_flag("--isolate",
+                     isolate,
+                     "Extract each file in a worker process, reporting and "
+                     "skipping files that crash or hang it");
+
+    app.add_option("--isolate-timeout",
+                   isolateTimeout,
+                   "Seconds a worker may spend on one file, 60 by default")
+        ->check(CLI::PositiveNumber)
+        ->needs(isolateFlag);
+
+    app.add_option("--isolate-memory",
+                   isolateMemory,
+                   "Megabytes of memory each worker may use, unlimited by "
+                   "default")
+        ->check(CLI::PositiveNumber)
+        ->needs(isolateFlag);
+
     CLI11_PARSE(app, argc, argv)
 
+    if (!diffPaths.empty())
+    {
+        return diffRivePaths(diffPaths[0],
+                             diffPaths[1],
+                             onlyStages.empty()
+                                 ? ExtractionStages::all()
+                                 : stagesFromNames(onlyStages));
+    }
+    uint32_t shardIndex = 0;
+    uint32_t shardCount = 0;
+    bool sharding = parseShard(shardSpec, shardIndex, shardCount);
+    bool merging = !mergePaths.empty();
+    if (merging && !inputPath.empty())
+    {
+        return app.exit(CLI::ExcludesError("--merge", "--input"));
+    }
+    if (merging && sharding)
+    {
+        return app.exit(CLI::ExcludesError("--merge", "--shard"));
+    }
+    if (profileTemplate && sharding)
+    {
+        return app.exit(CLI::ExcludesError("--profile-template", "--shard"));
+    }
+    // Merging reads partial results rather than Rive files
+    if (merging && isolate)
+    {
+        return app.exit(CLI::ExcludesError("--merge", "--isolate"));
+    }
+    // Only needed when generating code
+    if (inputPath.empty() && !merging)
+    {
+        return app.exit(CLI::RequiredError("--input"));
+    }
+    if (outputFilePath.empty())
+    {
+        return app.exit(CLI::RequiredError("--output"));
+    }
+
     std::string templateStr;
+    bool usingCustomTemplate = false;
     if (!templatePath.empty())
     {
         auto customTemplate = readTemplateFile(templatePath);
         if (customTemplate)
         {
             templateStr = *customTemplate;
+            usingCustomTemplate = true;
             std::cout << "Using custom template from: " << templatePath
                       << std::endl;
         }
@@ -743,331 +983,267 @@ int main(int argc, char* argv[])
                       << std::endl;
             return 1;
         }
+        // Language::Cpp and Language::Json are generated natively, without a
+        // template
     }
 
-    std::vector<std::string> riveFiles = findRiveFiles(inputPath);
-
-    if (riveFiles.empty())
+    // Files from stdin and archives are only known as they are read
+    bool inputIsStream = isStdinPath(inputPath) || isTarPath(inputPath);
+    if (inputIsStream && sharding)
     {
-        std::cerr << "No .riv files found in the specified path." << std::endl;
+        std::cerr << "Error: --shard needs a .riv file or directory as input"
+                  << std::endl;
         return 1;
     }
-
-    std::vector<RiveFileData> riveFileDataList;
-    for (const auto& riv_file : riveFiles)
+    if (inputIsStream && isolate)
     {
-        auto result = processRiveFile(riv_file);
-        if (result)
+        std::cerr << "Error: --isolate needs a .riv file or directory as "
+                     "input"
+                  << std::endl;
+        return 1;
+    }
+    IsolationLimits isolationLimits;
+    isolationLimits.timeout = std::chrono::seconds(isolateTimeout);
+    isolationLimits.memoryLimit = isolateMemory * 1024 * 1024;
+    const IsolationLimits* isolation = isolate ? &isolationLimits : nullptr;
+    std::vector<std::string> riveFiles;
+    if (!inputIsStream && !merging)
+    {
+        riveFiles = findRiveFiles(inputPath);
+        if (riveFiles.empty())
         {
-            riveFileDataList.push_back(*result);
+            std::cerr << "No .riv files found in the specified path."
+                      << std::endl;
+            return 1;
         }
-        // If result is nullopt, the error has already been printed
+    }
+    if (sharding)
+    {
+        // Every machine finds the same files, and keeps its shard of them
+        const auto inOtherShard = [&](const std::string& riveFile)
+        {
+            return shardOf(relativeRivePath(inputPath, riveFile),
+                           shardCount) != shardIndex;
+        };
+        riveFiles.erase(
+            std::remove_if(riveFiles.begin(), riveFiles.end(), inOtherShard),
+            riveFiles.end());
     }
 
-    // Mustache template rendering
-    kainjow::mustache::data templateData;
-    std::vector<kainjow::mustache::data> riveFileList;
+    std::cout << "Rive: output_file_path = " << outputFilePath << std::endl;
 
-    for (size_t fileIndex = 0; fileIndex < riveFileDataList.size();
-         fileIndex++)
+    std::filesystem::path output_path(outputFilePath);
+
+    // If only a filename is provided, use the current directory
+    if (output_path.is_relative() && output_path.parent_path().empty())
     {
-        const auto& fileData = riveFileDataList[fileIndex];
-        kainjow::mustache::data riveFileData;
-        riveFileData["riv_pascal_case"] = fileData.rivPascalCase;
-        riveFileData["riv_camel_case"] = fileData.rivCameCase;
-        riveFileData["riv_snake_case"] = fileData.riveSnakeCase;
-        riveFileData["riv_kebab_case"] = fileData.rivKebabCase;
-        riveFileData["last"] = (fileIndex == riveFileDataList.size() - 1);
+        output_path = std::filesystem::current_path() / output_path;
+    }
 
-        // Add enums to template data
-        std::vector<kainjow::mustache::data> enums;
-        for (size_t enumIndex = 0; enumIndex < fileData.enums.size();
-             enumIndex++)
+    // Create directories if they don't exist (this won't do anything if it's
+    // just a filename)
+    std::filesystem::create_directories(output_path.parent_path());
+
+    // The built-in C++ and JSON generators don't use templates, and the JSON
+    // one streams already
+    bool usesTemplate = usingCustomTemplate || language == Language::Dart;
+    if (profileTemplate && !usesTemplate)
+    {
+        std::cerr << "Error: --profile-template needs a template, and this "
+                     "language is generated without one"
+                  << std::endl;
+        return 1;
+    }
+
+    // Only the parts of the files that the output uses are extracted
+    ExtractionStages stages = ExtractionStages::all();
+    if (!onlyStages.empty())
+    {
+        stages = stagesFromNames(onlyStages);
+    }
+    else if (usesTemplate)
+    {
+        stages = stagesForTemplate(templateStr);
+    }
+    else if (language == Language::Cpp)
+    {
+        stages = cppHeaderStages();
+    }
+
+    std::optional<TemplateSplit> split;
+    // Profiling renders the whole template on one thread, so that its
+    // times add up
+    if (stream && usesTemplate && !sharding && !merging && !profileTemplate)
+    {
+        std::string error;
+        split = splitTemplate(templateStr, SplitMode::Streaming, error);
+        if (!split)
         {
-            const auto& enumInfo = fileData.enums[enumIndex];
-            kainjow::mustache::data enumData;
-            enumData["enum_name"] = enumInfo.name;
-            enumData["enum_camel_case"] = toCamelCase(enumInfo.name);
-            enumData["enum_pascal_case"] = toPascalCase(enumInfo.name);
-            enumData["enum_snake_case"] = toSnakeCase(enumInfo.name);
-            enumData["enum_kebab_case"] = toKebabCase(enumInfo.name);
-            enumData["last"] = (enumIndex == fileData.enums.size() - 1);
-
-            std::vector<kainjow::mustache::data> enumValues;
-            for (size_t valueIndex = 0; valueIndex < enumInfo.values.size();
-                 valueIndex++)
-            {
-                const auto& value = enumInfo.values[valueIndex];
-                kainjow::mustache::data valueData;
-                valueData["enum_value_key"] = value.key;
-                valueData["enum_value_camel_case"] = toCamelCase(value.key);
-                valueData["enum_value_pascal_case"] = toPascalCase(value.key);
-                valueData["enum_value_snake_case"] = toSnakeCase(value.key);
-                valueData["enum_value_kebab_case"] = toKebabCase(value.key);
-                valueData["last"] =
-                    (valueIndex == enumInfo.values.size() - 1);
-                enumValues.push_back(valueData);
-            }
-            enumData["enum_values"] = enumValues;
-            enums.push_back(enumData);
+            std::cout << "Can't stream this template (" << error
+                      << "), rendering all files at once." << std::endl;
         }
-        riveFileData["enums"] = enums;
+    }
 
-        // Add view models to template data
-        std::vector<kainjow::mustache::data> viewmodels;
-        for (size_t vmIndex = 0; vmIndex < fileData.viewmodels.size();
-             vmIndex++)
+    bool changed = false;
+    if (sharding)
+    {
+        if (!generatePartialResults(inputPath,
+                                    riveFiles,
+                                    shardIndex,
+                                    shardCount,
+                                    stages,
+                                    isolation,
+                                    output_path,
+                                    changed))
         {
-            const auto& viewModel = fileData.viewmodels[vmIndex];
-            kainjow::mustache::data viewmodelData;
-            viewmodelData["view_model_name"] = viewModel.name;
-            viewmodelData["view_model_camel_case"] =
-                toCamelCase(viewModel.name);
-            viewmodelData["view_model_pascal_case"] =
-                toPascalCase(viewModel.name);
-            viewmodelData["view_model_snake_case"] =
-                toSnakeCase(viewModel.name);
-            viewmodelData["view_model_kebab_case"] =
-                toKebabCase(viewModel.name);
-            viewmodelData["last"] =
-                (vmIndex == fileData.viewmodels.size() - 1);
-
-            std::vector<kainjow::mustache::data> properties;
-            for (size_t propIndex = 0;
-                 propIndex < viewModel.properties.size();
-                 propIndex++)
-            {
-                const auto& property = viewModel.properties[propIndex];
-                kainjow::mustache::data propertyData;
-                propertyData["property_name"] = property.name;
-                propertyData["property_camel_case"] =
-                    toCamelCase(property.name);
-                propertyData["property_pascal_case"] =
-                    toPascalCase(property.name);
-                propertyData["property_snake_case"] =
-                    toSnakeCase(property.name);
-                propertyData["property_kebab_case"] =
-                    toKebabCase(property.name);
-                propertyData["property_type"] = property.type;
-
-                // Add property type information for the viewmodel template
-                kainjow::mustache::data propertyTypeData;
-                propertyTypeData.set("is_view_model",
-                                       property.type == "viewModel");
-                propertyTypeData.set("is_enum", property.type == "enum");
-                propertyTypeData.set("is_string", property.type == "string");
-                propertyTypeData.set("is_number", property.type == "number");
-                propertyTypeData.set("is_integer",
-                                       property.type == "integer");
-                propertyTypeData.set("is_boolean",
-                                       property.type == "boolean");
-                propertyTypeData.set("is_color", property.type == "color");
-                propertyTypeData.set("is_list", property.type == "list");
-                propertyTypeData.set("is_trigger",
-                                       property.type == "trigger");
-                propertyTypeData.set("backing_name", property.backingName);
-                propertyTypeData.set("backing_camel_case",
-                                       toCamelCase(property.backingName));
-                propertyTypeData.set("backing_pascal_case",
-                                       toPascalCase(property.backingName));
-                propertyTypeData.set("backing_snake_case",
-                                       toSnakeCase(property.backingName));
-                propertyTypeData.set("backing_kebab_case",
-                                       toKebabCase(property.backingName));
-                propertyData.set("property_type", propertyTypeData);
-
-                propertyData["last"] =
-                    (propIndex == viewModel.properties.size() - 1);
-                properties.push_back(propertyData);
-            }
-            viewmodelData["properties"] = properties;
-            viewmodels.push_back(viewmodelData);
+            return 1;
         }
-        riveFileData["view_models"] = viewmodels;
-
-        std::vector<kainjow::mustache::data> assets;
-        for (size_t assetIndex = 0; assetIndex < fileData.assets.size();
-             assetIndex++)
+    }
+    else if (language == Language::Json && !usingCustomTemplate && !merging)
+    {
+        if (!generateJsonFile(inputPath,
+                              riveFiles,
+                              stages,
+                              isolation,
+                              output_path,
+                              changed))
         {
-            const auto& asset = fileData.assets[assetIndex];
-            kainjow::mustache::data assetData;
-            assetData["asset_name"] = asset.name;
-            assetData["asset_camel_case"] = toCamelCase(asset.name);
-            assetData["asset_pascal_case"] = toPascalCase(asset.name);
-            assetData["asset_snake_case"] = toSnakeCase(asset.name);
-            assetData["asset_kebab_case"] = toKebabCase(asset.name);
-            assetData["asset_type"] = asset.type;
-            assetData["asset_id"] = asset.assetId;
-            assetData["asset_cdn_uuid"] = asset.cdnUuid;
-            assetData["asset_cdn_base_url"] = asset.cdnBaseUrl;
-            assetData["last"] = (assetIndex == fileData.assets.size() - 1);
-            assets.push_back(assetData);
+            return 1;
         }
-        riveFileData["assets"] = assets;
-
-        std::vector<kainjow::mustache::data> artboardList;
-        for (size_t artboardIndex = 0;
-             artboardIndex < fileData.artboards.size();
-             artboardIndex++)
+    }
+    else if (split)
+    {
+        if (!generateStreamedFile(inputPath,
+                                  riveFiles,
+                                  stages,
+                                  isolation,
+                                  *split,
+                                  casesForTemplate(templateStr),
+                                  output_path,
+                                  changed))
         {
-            const auto& artboard = fileData.artboards[artboardIndex];
-            kainjow::mustache::data artboardData;
-            artboardData["artboard_name"] = artboard.artboardName;
-            artboardData["artboard_pascal_case"] =
-                artboard.artboardPascalCase;
-            artboardData["artboard_camel_case"] = artboard.artboardCameCase;
-            artboardData["artboard_snake_case"] = artboard.artboardSnakeCase;
-            artboardData["artboard_kebab_case"] = artboard.artboardKebabCase;
-            artboardData["last"] =
-                (artboardIndex == fileData.artboards.size() - 1);
-
-            std::unordered_set<std::string> usedAnimationNames;
-            std::vector<kainjow::mustache::data> animations;
-            for (size_t animIndex = 0; animIndex < artboard.animations.size();
-                 animIndex++)
-            {
-                const auto& animation = artboard.animations[animIndex];
-                kainjow::mustache::data animData;
-                auto uniqueName = makeUnique(animation, usedAnimationNames);
-                animData["animation_name"] = animation;
-                animData["animation_camel_case"] = toCamelCase(uniqueName);
-                animData["animation_pascal_case"] = toPascalCase(uniqueName);
-                animData["animation_snake_case"] = toSnakeCase(uniqueName);
-                animData["animation_kebab_case"] = toKebabCase(uniqueName);
-                animData["last"] =
-                    (animIndex == artboard.animations.size() - 1);
-                animations.push_back(animData);
-            }
-            artboardData["animations"] = animations;
-
-            std::unordered_set<std::string> usedStateMachineNames;
-            std::vector<kainjow::mustache::data> stateMachines;
-            for (size_t smIndex = 0; smIndex < artboard.stateMachines.size();
-                 smIndex++)
-            {
-                const auto& stateMachine = artboard.stateMachines[smIndex];
-                kainjow::mustache::data stateMachineData;
-                auto uniqueName =
-                    makeUnique(stateMachine.first, usedStateMachineNames);
-                stateMachineData["state_machine_name"] = stateMachine.first;
-                stateMachineData["state_machine_camel_case"] =
-                    toCamelCase(uniqueName);
-                stateMachineData["state_machine_pascal_case"] =
-                    toPascalCase(uniqueName);
-                stateMachineData["state_machine_snake_case"] =
-                    toSnakeCase(uniqueName);
-                stateMachineData["state_machine_kebab_case"] =
-                    toKebabCase(uniqueName);
-                stateMachineData["last"] =
-                    (smIndex == artboard.stateMachines.size() - 1);
-
-                std::unordered_set<std::string> usedInputNames;
-                std::vector<kainjow::mustache::data> inputs;
-                for (size_t inputIndex = 0;
-                     inputIndex < stateMachine.second.size();
-                     inputIndex++)
-                {
-                    const auto& input = stateMachine.second[inputIndex];
-                    kainjow::mustache::data inputData;
-                    auto uniqueName = makeUnique(input.name, usedInputNames);
-                    inputData["input_name"] = input.name;
-                    inputData["input_camel_case"] = toCamelCase(uniqueName);
-                    inputData["input_pascal_case"] = toPascalCase(uniqueName);
-                    inputData["input_snake_case"] = toSnakeCase(uniqueName);
-                    inputData["input_kebab_case"] = toKebabCase(uniqueName);
-                    inputData["input_type"] = input.type;
-                    inputData["input_default_value"] = input.defaultValue;
-                    inputData["last"] =
-                        (inputIndex == stateMachine.second.size() - 1);
-                    inputs.push_back(inputData);
-                }
-                stateMachineData["inputs"] = inputs;
-
-                stateMachines.push_back(stateMachineData);
-            }
-            artboardData["state_machines"] = stateMachines;
+            return 1;
+        }
+    }
+    else
+    {
+        StructureInterner interner;
+        std::vector<RiveFileData> riveFileDataList;
+        const auto add = [&](RiveFileData&& fileData)
+        { riveFileDataList.push_back(std::move(fileData)); };
+        bool extracted =
+            merging ? mergePartialResults(mergePaths,
+                                          stages,
+                                          interner,
+                                          riveFileDataList)
+                    : extractRiveFiles(inputPath,
+                                       riveFiles,
+                                       stages,
+                                       isolation,
+                                       &interner,
+                                       add);
+        if (!extracted)
+        {
+            return 1;
+        }
 
-            std::unordered_set<std::string> usedTextValueRunNames;
-            std::vector<kainjow::mustache::data> textValueRuns;
-            for (size_t tvrIndex = 0;
-                 tvrIndex < artboard.textValueRuns.size();
-                 tvrIndex++)
+        std::string result;
+        std::string profile;
+        if (profileTemplate)
+        {
+            // Rendered by kainjow rather than compiled, which makes the same
+            // output
+            result = renderTemplateProfiled(
+                templateStr,
+                buildTemplateData(riveFileDataList,
+                                  casesForTemplate(templateStr)),
+                profile);
+        }
+        else if (language == Language::Cpp && !usingCustomTemplate)
+        {
+            auto header =
+                generateCppHeader(riveFileDataList, generatedFileName);
+            if (!header)
             {
-                const auto& tvr = artboard.textValueRuns[tvrIndex];
-                kainjow::mustache::data tvrData;
-                auto uniqueName = makeUnique(tvr.name, usedTextValueRunNames);
-                tvrData["text_value_run_name"] = tvr.name;
-                tvrData["text_value_run_camel_case"] =
-                    toCamelCase(uniqueName);
-                tvrData["text_value_run_pascal_case"] =
-                    toPascalCase(uniqueName);
-                tvrData["text_value_run_snake_case"] =
-                    toSnakeCase(uniqueName);
-                tvrData["text_value_run_kebab_case"] =
-                    toKebabCase(uniqueName);
-                tvrData["text_value_run_default"] = tvr.defaultValue;
-                tvrData["text_value_run_default_sanitized"] =
-                    sanitizeString(tvr.defaultValue);
-                tvrData["last"] =
-                    (tvrIndex == artboard.textValueRuns.size() - 1);
-                textValueRuns.push_back(tvrData);
+                return 1;
             }
-            artboardData["text_value_runs"] = textValueRuns;
-
-            std::vector<kainjow::mustache::data> nestedTextValueRuns;
-            for (size_t ntvrIndex = 0;
-                 ntvrIndex < artboard.nestedTextValueRuns.size();
-                 ntvrIndex++)
+            result = std::move(*header);
+        }
+        else if (language == Language::Json && !usingCustomTemplate)
+        {
+            std::ostringstream output;
+            JsonGenerator json(output);
+            for (const auto& fileData : riveFileDataList)
             {
-                const auto& ntvr = artboard.nestedTextValueRuns[ntvrIndex];
-                kainjow::mustache::data ntvrData;
-                ntvrData["nested_text_value_run_name"] = ntvr.name;
-                ntvrData["nested_text_value_run_path"] = ntvr.path;
-                ntvrData["last"] =
-                    (ntvrIndex == artboard.nestedTextValueRuns.size() - 1);
-                nestedTextValueRuns.push_back(ntvrData);
+                json.addFile(fileData);
             }
-
-            artboardData["nested_text_value_runs"] = nestedTextValueRuns;
-
-            artboardList.push_back(artboardData);
+            json.finish();
+            result = output.str();
+        }
+        else if (!usingCustomTemplate)
+        {
+            // The built-in Dart template is compiled into C++ at build time
+            renderDefaultDartTemplate(riveFileDataList,
+                                      generatedFileName,
+                                      result);
+        }
+        else
+        {
+            result = ParsedTemplate(templateStr).render(riveFileDataList);
         }
 
-        riveFileData["artboards"] = artboardList;
-        riveFileList.push_back(riveFileData);
+        if (!writeFileIfChanged(output_path, result, changed))
+        {
+            return 1;
+        }
+        std::cout << profile;
     }
 
-    templateData["generated_file_name"] = generatedFileName;
-    templateData["riv_files"] = riveFileList;
-
-    kainjow::mustache::mustache tmpl(templateStr);
-    std::string result = tmpl.render(templateData);
-
-    std::cout << "Rive: output_file_path = " << outputFilePath << std::endl;
-
-    std::filesystem::path output_path(outputFilePath);
-
-    // If only a filename is provided, use the current directory
-    if (output_path.is_relative() && output_path.parent_path().empty())
+    if (changed)
     {
-        output_path = std::filesystem::current_path() / output_path;
+        std::cout << "File generated successfully: " << output_path
+                  << std::endl;
     }
-
-    // Create directories if they don't exist (this won't do anything if it's
-    // just a filename)
-    std::filesystem::create_directories(output_path.parent_path());
-
-    std::ofstream output_file(output_path);
-    if (!output_file.is_open())
+    else
     {
-        std::cerr << "Error: Unable to open output file: " << output_path
+        std::cout << "File unchanged, skipped writing: " << output_path
                   << std::endl;
-        return 1;
     }
-    output_file << result;
-    output_file.close();
 
-    std::cout << "File generated successfully: " << output_path << std::endl;
+    if (!depfilePath.empty())
+    {
+        std::vector<std::string> dependencies;
+        if (std::filesystem::is_directory(inputPath) || isTarPath(inputPath))
+        {
+            // Adding or removing a .riv file changes the directory or
+            // archive itself. Files from stdin have nothing to depend on.
+            dependencies.push_back(inputPath);
+        }
+        dependencies.insert(dependencies.end(),
+                            riveFiles.begin(),
+                            riveFiles.end());
+        dependencies.insert(dependencies.end(),
+                            mergePaths.begin(),
+                            mergePaths.end());
+        if (usingCustomTemplate)
+        {
+            dependencies.push_back(templatePath);
+        }
+
+        std::filesystem::path depfile_path(depfilePath);
+        if (depfile_path.has_parent_path())
+        {
+            std::filesystem::create_directories(depfile_path.parent_path());
+        }
+
+        bool depfileChanged = false;
+        if (!writeFileIfChanged(depfile_path,
+                                makeDepfile(outputFilePath, dependencies),
+                                depfileChanged))
+        {
+            return 1;
+        }
+    }
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "naming.h"
+
+#include <cctype>
+
+// Helper function to convert a string to the specified case style
+static std::string toCaseHelper(const std::string& str, CaseStyle style)
+{
+    // Built in place, since these run for every name in every file
+    std::string result;
+    result.reserve(str.size() + 1);
+    bool capitalizeNext = (style == CaseStyle::Pascal);
+    bool firstChar = true;
+
+    // Check if the first character is a digit
+    if (std::isdigit(str[0]))
+    {
+        result += 'n';         // Prepend 'n' for number
+        capitalizeNext = true; // Capitalize the first digit
+        firstChar = false;
+    }
+
+    // Process the string
+    for (size_t i = 0; i < str.length(); i++)
+    {
+        char c = str[i];
+
+        if (std::isalnum(c))
+        {
+            if (capitalizeNext)
+            {
+                result += (char)std::toupper(c);
+                capitalizeNext = false;
+            }
+            else
+            {
+                result += (style == CaseStyle::Pascal ? c
+                                                      : (char)std::tolower(c));
+            }
+            firstChar = false;
+        }
+        else if (c == ' ' || c == '_' || c == '-')
+        {
+            if (!firstChar)
+            {
+                switch (style)
+                {
+                    case CaseStyle::Camel:
+                    case CaseStyle::Pascal:
+                        capitalizeNext = true;
+                        break;
+                    case CaseStyle::Snake:
+                        result += '_';
+                        break;
+                    case CaseStyle::Kebab:
+                        result += '-';
+                        break;
+                }
+            }
+        }
+        // All other characters are ignored
+    }
+
+    // Ensure the result is not empty and starts with a letter
+    if (result.empty() || !std::isalpha(result[0]))
+    {
+        result.insert(result.begin(), 'X');
+    }
+
+    return result;
+}
+
+std::string toCamelCase(const std::string& str)
+{
+    std::string result = toCaseHelper(str, CaseStyle::Camel);
+    // TODO: These handlers are generic to dart, we need to make something more
+    // generic to handle all languages
+    // Handle Dart reserved keywords
+    if (result == "with" || result == "class" || result == "enum" ||
+        result == "var" || result == "const" || result == "final" ||
+        result == "static" || result == "void" || result == "int" ||
+        result == "double" || result == "bool" || result == "String" ||
+        result == "List" || result == "Map" || result == "dynamic" ||
+        result == "null" || result == "true" || result == "false")
+    {
+        result += "Value";
+    }
+    return result;
+}
+
+std::string toPascalCase(const std::string& str)
+{
+    return toCaseHelper(str, CaseStyle::Pascal);
+}
+
+std::string toSnakeCase(const std::string& str)
+{
+    return toCaseHelper(str, CaseStyle::Snake);
+}
+
+std::string toKebabCase(const std::string& str)
+{
+    return toCaseHelper(str, CaseStyle::Kebab);
+}
+
+std::string makeUnique(const std::string& base,
+                       std::unordered_set<std::string>& usedNames)
+{
+    std::string uniqueName = base;
+    int counter = 1;
+    while (usedNames.find(uniqueName) != usedNames.end())
+    {
+        uniqueName = base + "U" + std::to_string(counter);
+        counter++;
+    }
+    usedNames.insert(uniqueName);
+    return uniqueName;
+}
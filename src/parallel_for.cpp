@@ -0,0 +1,151 @@
+#include "parallel_for.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// One parallelFor call, which lives on the stack of the thread that made it
+struct ParallelLoop
+{
+    size_t count;
+    const std::function<void(size_t)>* work;
+    // Guarded by the pool's mutex
+    size_t next = 0;
+    size_t done = 0;
+    // The first exception an index threw, which ends the loop early
+    std::exception_ptr error;
+};
+
+class ThreadPool
+{
+public:
+    ThreadPool()
+    {
+        unsigned int threadCount =
+            std::max(std::thread::hardware_concurrency(), 1u);
+        // The thread calling parallelFor is the last one
+        for (unsigned int i = 1; i < threadCount; i++)
+        {
+            std::thread(&ThreadPool::workerMain, this).detach();
+        }
+    }
+
+    void run(size_t count, const std::function<void(size_t)>& work)
+    {
+        ParallelLoop loop{count, &work};
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_loops.push_back(&loop);
+        m_changed.notify_all();
+        while (loop.done < loop.count)
+        {
+            // Its own indices first, then helping others while the last of
+            // its own finish elsewhere
+            if (loop.next < loop.count)
+            {
+                runIndex(&loop, lock);
+            }
+            else if (!m_loops.empty())
+            {
+                runIndex(m_loops.back(), lock);
+            }
+            else
+            {
+                m_changed.wait(lock);
+            }
+        }
+        if (loop.error)
+        {
+            std::rethrow_exception(loop.error);
+        }
+    }
+
+private:
+    void workerMain()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            if (m_loops.empty())
+            {
+                m_changed.wait(lock);
+                continue;
+            }
+            // The newest loop is the most deeply nested one, and finishing
+            // it lets the thread waiting on it get back to its own loop
+            runIndex(m_loops.back(), lock);
+        }
+    }
+
+    // Claims the next index of `loop` and runs it with the lock released. If
+    // it throws, the indices no one has claimed yet are skipped and the
+    // exception is rethrown on the thread that called parallelFor.
+    void runIndex(ParallelLoop* loop, std::unique_lock<std::mutex>& lock)
+    {
+        size_t index = loop->next++;
+        if (loop->next == loop->count)
+        {
+            m_loops.erase(std::find(m_loops.begin(), m_loops.end(), loop));
+        }
+
+        lock.unlock();
+        std::exception_ptr error;
+        try
+        {
+            (*loop->work)(index);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        lock.lock();
+
+        if (error)
+        {
+            if (!loop->error)
+            {
+                loop->error = error;
+            }
+            if (loop->next < loop->count)
+            {
+                m_loops.erase(
+                    std::find(m_loops.begin(), m_loops.end(), loop));
+                loop->done += loop->count - loop->next;
+                loop->next = loop->count;
+            }
+        }
+        if (++loop->done == loop->count)
+        {
+            m_changed.notify_all();
+        }
+    }
+
+    std::mutex m_mutex;
+    // Notified when a loop is added or finishes
+    std::condition_variable m_changed;
+    // Loops with indices left to claim, oldest first
+    std::vector<ParallelLoop*> m_loops;
+};
+
+static std::atomic<bool> serial{false};
+
+void runParallelForSerially() { serial = true; }
+
+void parallelFor(size_t count, const std::function<void(size_t)>& work)
+{
+    if (count <= 1 || serial)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            work(i);
+        }
+        return;
+    }
+
+    // Never destroyed, so exiting doesn't wait on its idle threads
+    static ThreadPool* pool = new ThreadPool();
+    pool->run(count, work);
+}
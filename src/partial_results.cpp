@@ -0,0 +1,480 @@
+#include "partial_results.h"
+
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+// Starts every partial results file, followed by the format version
+static const std::string partialMagic = "RIVEPART";
+static constexpr uint64_t partialVersion = 3;
+
+// Numbers are unsigned LEB128 and strings are their size then their bytes,
+// so that small values, which are most of them, take a byte
+class PartialWriter
+{
+public:
+    void number(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            m_output += static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        m_output += static_cast<char>(value);
+    }
+
+    void string(const std::string& value)
+    {
+        number(value.size());
+        m_output += value;
+    }
+
+    void strings(const std::vector<std::string>& values)
+    {
+        number(values.size());
+        for (const auto& value : values)
+        {
+            string(value);
+        }
+    }
+
+    std::string& output() { return m_output; }
+
+private:
+    std::string m_output;
+};
+
+// Reads what PartialWriter writes. Reading past the end or a malformed
+// number marks the reader failed and returns empty values from then on.
+class PartialReader
+{
+public:
+    explicit PartialReader(const std::string& bytes) : m_bytes(bytes) {}
+
+    uint64_t number()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64 && !m_failed; shift += 7)
+        {
+            if (m_offset >= m_bytes.size())
+            {
+                break;
+            }
+            auto byte = static_cast<unsigned char>(m_bytes[m_offset++]);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return value;
+            }
+        }
+        m_failed = true;
+        return 0;
+    }
+
+    // A number of items that follow, each of which takes at least a byte,
+    // so that a corrupt count can't allocate more than the data could hold
+    size_t count()
+    {
+        uint64_t value = number();
+        if (value > m_bytes.size() - m_offset)
+        {
+            m_failed = true;
+            return 0;
+        }
+        return static_cast<size_t>(value);
+    }
+
+    std::string string()
+    {
+        size_t size = count();
+        std::string value = m_bytes.substr(m_offset, size);
+        m_offset += size;
+        return value;
+    }
+
+    std::vector<std::string> strings()
+    {
+        std::vector<std::string> values(count());
+        for (auto& value : values)
+        {
+            value = string();
+        }
+        return values;
+    }
+
+    // Reads raw bytes, which must match `expected`
+    bool expect(const std::string& expected)
+    {
+        if (m_bytes.compare(m_offset, expected.size(), expected) != 0)
+        {
+            m_failed = true;
+            return false;
+        }
+        m_offset += expected.size();
+        return true;
+    }
+
+    void fail() { m_failed = true; }
+    bool failed() const { return m_failed; }
+    bool atEnd() const { return m_offset == m_bytes.size(); }
+
+private:
+    const std::string& m_bytes;
+    size_t m_offset = 0;
+    bool m_failed = false;
+};
+
+// Each distinct structure is written once, in the order first used, and
+// files refer to them by index
+template <typename T>
+class StructureTable
+{
+public:
+    void add(const std::shared_ptr<const T>& structure)
+    {
+        if (m_indices.emplace(structure.get(), m_structures.size()).second)
+        {
+            m_structures.push_back(structure.get());
+        }
+    }
+
+    size_t indexOf(const std::shared_ptr<const T>& structure) const
+    {
+        return m_indices.at(structure.get());
+    }
+
+    const std::vector<const T*>& structures() const { return m_structures; }
+
+private:
+    std::unordered_map<const T*, size_t> m_indices;
+    std::vector<const T*> m_structures;
+};
+
+static void writeArtboard(PartialWriter& writer, const ArtboardData& artboard)
+{
+    writer.string(artboard.artboardName);
+    writer.string(artboard.artboardPascalCase);
+    writer.string(artboard.artboardCameCase);
+    writer.string(artboard.artboardSnakeCase);
+    writer.string(artboard.artboardKebabCase);
+    writer.strings(artboard.animations);
+    writer.number(artboard.stateMachines.size());
+    for (const auto& stateMachine : artboard.stateMachines)
+    {
+        writer.string(stateMachine.first);
+        writer.number(stateMachine.second.size());
+        for (const auto& input : stateMachine.second)
+        {
+            writer.string(input.name);
+            writer.string(input.type);
+            writer.string(input.defaultValue);
+        }
+    }
+    writer.number(artboard.textValueRuns.size());
+    for (const auto& textValueRun : artboard.textValueRuns)
+    {
+        writer.string(textValueRun.name);
+        writer.string(textValueRun.defaultValue);
+    }
+    writer.number(artboard.nestedTextValueRuns.size());
+    for (const auto& nestedTextValueRun : artboard.nestedTextValueRuns)
+    {
+        writer.string(nestedTextValueRun.name);
+        writer.string(nestedTextValueRun.path);
+    }
+    writer.number(artboard.nestedArtboards.size());
+    for (const auto& nestedArtboard : artboard.nestedArtboards)
+    {
+        writer.string(nestedArtboard.name);
+        writer.string(nestedArtboard.artboardName);
+        writer.number(nestedArtboard.artboardIndex);
+    }
+}
+
+static ArtboardData readArtboard(PartialReader& reader)
+{
+    ArtboardData artboard;
+    artboard.artboardName = reader.string();
+    artboard.artboardPascalCase = reader.string();
+    artboard.artboardCameCase = reader.string();
+    artboard.artboardSnakeCase = reader.string();
+    artboard.artboardKebabCase = reader.string();
+    artboard.animations = reader.strings();
+    artboard.stateMachines.resize(reader.count());
+    for (auto& stateMachine : artboard.stateMachines)
+    {
+        stateMachine.first = reader.string();
+        stateMachine.second.resize(reader.count());
+        for (auto& input : stateMachine.second)
+        {
+            input.name = reader.string();
+            input.type = reader.string();
+            input.defaultValue = reader.string();
+        }
+    }
+    artboard.textValueRuns.resize(reader.count());
+    for (auto& textValueRun : artboard.textValueRuns)
+    {
+        textValueRun.name = reader.string();
+        textValueRun.defaultValue = reader.string();
+    }
+    artboard.nestedTextValueRuns.resize(reader.count());
+    for (auto& nestedTextValueRun : artboard.nestedTextValueRuns)
+    {
+        nestedTextValueRun.name = reader.string();
+        nestedTextValueRun.path = reader.string();
+    }
+    artboard.nestedArtboards.resize(reader.count());
+    for (auto& nestedArtboard : artboard.nestedArtboards)
+    {
+        nestedArtboard.name = reader.string();
+        nestedArtboard.artboardName = reader.string();
+        nestedArtboard.artboardIndex = reader.number();
+    }
+    return artboard;
+}
+
+static void writeEnum(PartialWriter& writer, const EnumInfo& enumInfo)
+{
+    writer.string(enumInfo.name);
+    writer.number(enumInfo.values.size());
+    for (const auto& value : enumInfo.values)
+    {
+        writer.string(value.key);
+    }
+}
+
+static EnumInfo readEnum(PartialReader& reader)
+{
+    EnumInfo enumInfo;
+    enumInfo.name = reader.string();
+    enumInfo.values.resize(reader.count());
+    for (auto& value : enumInfo.values)
+    {
+        value.key = reader.string();
+    }
+    return enumInfo;
+}
+
+static void writeViewModel(PartialWriter& writer,
+                           const ViewModelInfo& viewModel)
+{
+    writer.string(viewModel.name);
+    writer.number(viewModel.properties.size());
+    for (const auto& property : viewModel.properties)
+    {
+        writer.string(property.name);
+        writer.string(property.type);
+        writer.string(property.backingName);
+    }
+}
+
+static ViewModelInfo readViewModel(PartialReader& reader)
+{
+    ViewModelInfo viewModel;
+    viewModel.name = reader.string();
+    viewModel.properties.resize(reader.count());
+    for (auto& property : viewModel.properties)
+    {
+        property.name = reader.string();
+        property.type = reader.string();
+        property.backingName = reader.string();
+    }
+    return viewModel;
+}
+
+template <typename T, typename Write>
+static void writeTable(PartialWriter& writer,
+                       const StructureTable<T>& table,
+                       const Write& write)
+{
+    writer.number(table.structures().size());
+    for (const T* structure : table.structures())
+    {
+        write(writer, *structure);
+    }
+}
+
+template <typename T>
+static void writeIndices(PartialWriter& writer,
+                         const StructureTable<T>& table,
+                         const std::vector<std::shared_ptr<const T>>& items)
+{
+    writer.number(items.size());
+    for (const auto& item : items)
+    {
+        writer.number(table.indexOf(item));
+    }
+}
+
+template <typename T, typename Read>
+static std::vector<std::shared_ptr<const T>> readTable(
+    PartialReader& reader,
+    StructureInterner& interner,
+    const Read& read)
+{
+    std::vector<std::shared_ptr<const T>> structures(reader.count());
+    for (auto& structure : structures)
+    {
+        structure = interner.intern(read(reader));
+    }
+    return structures;
+}
+
+template <typename T>
+static std::vector<std::shared_ptr<const T>> readIndices(
+    PartialReader& reader,
+    const std::vector<std::shared_ptr<const T>>& table)
+{
+    std::vector<std::shared_ptr<const T>> items(reader.count());
+    for (auto& item : items)
+    {
+        size_t index = reader.number();
+        if (index >= table.size())
+        {
+            reader.fail();
+            return {};
+        }
+        item = table[index];
+    }
+    return items;
+}
+
+uint32_t shardOf(const std::string& relativePath, uint32_t shardCount)
+{
+    // FNV-1a, which unlike std::hash is the same everywhere
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : relativePath)
+    {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    return static_cast<uint32_t>(hash % shardCount);
+}
+
+std::string serializePartialResults(const PartialResults& partial)
+{
+    StructureTable<ArtboardData> artboards;
+    StructureTable<EnumInfo> enums;
+    StructureTable<ViewModelInfo> viewModels;
+    for (const auto& file : partial.files)
+    {
+        for (const auto& artboard : file.data.artboards)
+        {
+            artboards.add(artboard);
+        }
+        for (const auto& enumInfo : file.data.enums)
+        {
+            enums.add(enumInfo);
+        }
+        for (const auto& viewModel : file.data.viewmodels)
+        {
+            viewModels.add(viewModel);
+        }
+    }
+
+    PartialWriter writer;
+    writer.output() += partialMagic;
+    writer.number(partialVersion);
+    writer.number(partial.shardIndex);
+    writer.number(partial.shardCount);
+    writer.number(stagesToBits(partial.stages));
+
+    writeTable(writer, artboards, writeArtboard);
+    writeTable(writer, enums, writeEnum);
+    writeTable(writer, viewModels, writeViewModel);
+
+    writer.number(partial.files.size());
+    for (const auto& file : partial.files)
+    {
+        const RiveFileData& data = file.data;
+        writer.string(file.relativePath);
+        writer.string(data.rivName);
+        writer.string(data.rivPascalCase);
+        writer.string(data.rivCameCase);
+        writer.string(data.riveSnakeCase);
+        writer.string(data.rivKebabCase);
+        writer.number(data.fingerprint);
+        writeIndices(writer, artboards, data.artboards);
+        writer.number(data.assets.size());
+        for (const auto& asset : data.assets)
+        {
+            writer.string(asset.name);
+            writer.string(asset.type);
+            writer.string(asset.fileExtension);
+            writer.string(asset.assetId);
+            writer.string(asset.cdnUuid);
+            writer.string(asset.cdnBaseUrl);
+        }
+        writeIndices(writer, enums, data.enums);
+        writeIndices(writer, viewModels, data.viewmodels);
+    }
+    return std::move(writer.output());
+}
+
+std::optional<PartialResults> deserializePartialResults(
+    const std::string& bytes,
+    const std::string& path,
+    StructureInterner& interner)
+{
+    PartialReader reader(bytes);
+    if (!reader.expect(partialMagic))
+    {
+        std::cerr << "Error: Not a partial results file: " << path
+                  << std::endl;
+        return std::nullopt;
+    }
+    uint64_t version = reader.number();
+    if (version != partialVersion)
+    {
+        std::cerr << "Error: Partial results file " << path
+                  << " is from a different version of the generator"
+                  << std::endl;
+        return std::nullopt;
+    }
+
+    PartialResults partial;
+    partial.shardIndex = static_cast<uint32_t>(reader.number());
+    partial.shardCount = static_cast<uint32_t>(reader.number());
+    partial.stages = stagesFromBits(static_cast<uint32_t>(reader.number()));
+
+    auto artboards = readTable<ArtboardData>(reader, interner, readArtboard);
+    auto enums = readTable<EnumInfo>(reader, interner, readEnum);
+    auto viewModels =
+        readTable<ViewModelInfo>(reader, interner, readViewModel);
+
+    partial.files.resize(reader.count());
+    for (auto& file : partial.files)
+    {
+        RiveFileData& data = file.data;
+        file.relativePath = reader.string();
+        data.rivName = reader.string();
+        data.rivPascalCase = reader.string();
+        data.rivCameCase = reader.string();
+        data.riveSnakeCase = reader.string();
+        data.rivKebabCase = reader.string();
+        data.fingerprint = reader.number();
+        data.artboards = readIndices(reader, artboards);
+        data.assets.resize(reader.count());
+        for (auto& asset : data.assets)
+        {
+            asset.name = reader.string();
+            asset.type = reader.string();
+            asset.fileExtension = reader.string();
+            asset.assetId = reader.string();
+            asset.cdnUuid = reader.string();
+            asset.cdnBaseUrl = reader.string();
+        }
+        data.enums = readIndices(reader, enums);
+        data.viewmodels = readIndices(reader, viewModels);
+    }
+
+    if (reader.failed() || !reader.atEnd() || partial.shardCount == 0 ||
+        partial.shardIndex >= partial.shardCount)
+    {
+        std::cerr << "Error: Partial results file is corrupt: " << path
+                  << std::endl;
+        return std::nullopt;
+    }
+    return partial;
+}
@@ -0,0 +1,209 @@
+#include "rive_codegen.h"
+
+#include <cstring>
+#include <exception>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "extraction_stages.h"
+#include "rive_extractor.h"
+#include "rive_file_data.h"
+#include "structure_interner.h"
+#include "template_render.h"
+
+struct rive_codegen_context
+{
+    StructureInterner interner;
+};
+
+struct rive_codegen_file
+{
+    RiveFileData data;
+};
+
+struct rive_codegen_template
+{
+    ParsedTemplate parsed;
+};
+
+static thread_local std::string lastError;
+
+static rive_codegen_status fail(rive_codegen_status status,
+                                std::string message)
+{
+    lastError = std::move(message);
+    return status;
+}
+
+// Doesn't throw, since it's called while handling an exception, which may
+// be that memory ran out
+static rive_codegen_status internalError(const char* what)
+{
+    try
+    {
+        lastError = std::string("Internal error: ") + what;
+    }
+    catch (...)
+    {
+        lastError.clear();
+    }
+    return RIVE_CODEGEN_INTERNAL_ERROR;
+}
+
+// Exceptions mustn't cross the C API, so the calls that can throw report
+// them as internal errors instead
+template <typename Call>
+static rive_codegen_status guard(const Call& call)
+{
+    try
+    {
+        return call();
+    }
+    catch (const std::exception& e)
+    {
+        return internalError(e.what());
+    }
+    catch (...)
+    {
+        return internalError("unknown exception");
+    }
+}
+
+uint32_t rive_codegen_api_version(void) { return RIVE_CODEGEN_API_VERSION; }
+
+const char* rive_codegen_last_error(void) { return lastError.c_str(); }
+
+rive_codegen_context* rive_codegen_context_create(void)
+{
+    return new (std::nothrow) rive_codegen_context();
+}
+
+void rive_codegen_context_destroy(rive_codegen_context* context)
+{
+    delete context;
+}
+
+rive_codegen_status rive_codegen_file_open(rive_codegen_context* context,
+                                           const char* name,
+                                           size_t name_size,
+                                           const uint8_t* bytes,
+                                           size_t size,
+                                           uint32_t stages,
+                                           rive_codegen_file** file)
+{
+    if (!context || !name || (!bytes && size > 0) || !file ||
+        (stages & ~RIVE_CODEGEN_STAGE_ALL) != 0)
+    {
+        return fail(RIVE_CODEGEN_INVALID_ARGUMENT,
+                    "Invalid argument to rive_codegen_file_open");
+    }
+
+    return guard(
+        [&]()
+        {
+            std::string path(name, name_size);
+            auto data = processRiveBytes(path,
+                                         bytes,
+                                         size,
+                                         context->interner,
+                                         stagesFromBits(stages));
+            if (!data)
+            {
+                return fail(RIVE_CODEGEN_INVALID_FILE,
+                            "Failed to parse Rive file: " + path);
+            }
+            *file = new rive_codegen_file{std::move(*data)};
+            return RIVE_CODEGEN_OK;
+        });
+}
+
+void rive_codegen_file_close(rive_codegen_file* file) { delete file; }
+
+rive_codegen_status rive_codegen_template_parse(const char* source,
+                                                size_t size,
+                                                rive_codegen_template** tmpl)
+{
+    if ((!source && size > 0) || !tmpl)
+    {
+        return fail(RIVE_CODEGEN_INVALID_ARGUMENT,
+                    "Invalid argument to rive_codegen_template_parse");
+    }
+
+    return guard(
+        [&]()
+        {
+            ParsedTemplate parsed(std::string(source, size));
+            if (!parsed.error().empty())
+            {
+                return fail(RIVE_CODEGEN_INVALID_TEMPLATE, parsed.error());
+            }
+            *tmpl = new rive_codegen_template{std::move(parsed)};
+            return RIVE_CODEGEN_OK;
+        });
+}
+
+void rive_codegen_template_destroy(rive_codegen_template* tmpl)
+{
+    delete tmpl;
+}
+
+uint32_t rive_codegen_template_stages(const rive_codegen_template* tmpl)
+{
+    if (!tmpl)
+    {
+        return 0;
+    }
+    return stagesToBits(tmpl->parsed.stages());
+}
+
+rive_codegen_status rive_codegen_render(const rive_codegen_template* tmpl,
+                                        rive_codegen_file* const* files,
+                                        size_t file_count,
+                                        char* buffer,
+                                        size_t capacity,
+                                        size_t* size)
+{
+    if (!tmpl || (!files && file_count > 0) || (!buffer && capacity > 0) ||
+        !size)
+    {
+        return fail(RIVE_CODEGEN_INVALID_ARGUMENT,
+                    "Invalid argument to rive_codegen_render");
+    }
+
+    for (size_t i = 0; i < file_count; i++)
+    {
+        if (!files[i])
+        {
+            return fail(RIVE_CODEGEN_INVALID_ARGUMENT,
+                        "Invalid argument to rive_codegen_render");
+        }
+    }
+
+    return guard(
+        [&]()
+        {
+            std::vector<RiveFileData> fileDataList;
+            fileDataList.reserve(file_count);
+            for (size_t i = 0; i < file_count; i++)
+            {
+                fileDataList.push_back(files[i]->data);
+            }
+
+            std::string output = tmpl->parsed.render(fileDataList);
+            *size = output.size();
+            if (output.size() > capacity)
+            {
+                return fail(RIVE_CODEGEN_BUFFER_TOO_SMALL,
+                            "Output of " + std::to_string(output.size()) +
+                                " bytes doesn't fit in " +
+                                std::to_string(capacity));
+            }
+            if (!output.empty())
+            {
+                std::memcpy(buffer, output.data(), output.size());
+            }
+            return RIVE_CODEGEN_OK;
+        });
+}
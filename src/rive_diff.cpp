@@ -0,0 +1,358 @@
+#include "rive_diff.h"
+
+#include <memory>
+#include <unordered_map>
+
+#include "string_escape.h"
+
+static const std::string& nameOf(const std::string& name) { return name; }
+static const std::string& nameOf(const InputInfo& input) { return input.name; }
+
+static const std::string& nameOf(const TextValueRunInfo& textValueRun)
+{
+    return textValueRun.name;
+}
+
+static const std::string& nameOf(const NestedTextValueRunInfo& nested)
+{
+    return nested.name;
+}
+
+static const std::string& nameOf(const NestedArtboardInfo& nested)
+{
+    return nested.name;
+}
+
+static const std::string& nameOf(const AssetInfo& asset) { return asset.name; }
+
+static const std::string& nameOf(const EnumValueInfo& value)
+{
+    return value.key;
+}
+
+static const std::string& nameOf(const PropertyInfo& property)
+{
+    return property.name;
+}
+
+static const std::string& nameOf(
+    const std::pair<std::string, std::vector<InputInfo>>& stateMachine)
+{
+    return stateMachine.first;
+}
+
+static const std::string& nameOf(const RiveFileData& file)
+{
+    return file.rivName;
+}
+
+static const std::string& nameOf(const ArtboardData& artboard)
+{
+    return artboard.artboardName;
+}
+
+static const std::string& nameOf(const EnumInfo& enumInfo)
+{
+    return enumInfo.name;
+}
+
+static const std::string& nameOf(const ViewModelInfo& viewModel)
+{
+    return viewModel.name;
+}
+
+template <typename T>
+static const std::string& nameOf(const std::shared_ptr<const T>& structure)
+{
+    return nameOf(*structure);
+}
+
+class RiveDiffer
+{
+public:
+    std::vector<RiveChange> changes;
+
+    void diffFile(const RiveFileData& before, const RiveFileData& after)
+    {
+        m_path.push_back(after.rivName);
+        diffFileContents(before, after);
+        m_path.pop_back();
+    }
+
+    void diffFiles(const std::vector<RiveFileData>& before,
+                   const std::vector<RiveFileData>& after)
+    {
+        diffByName("file",
+                   before,
+                   after,
+                   [this](const RiveFileData& a, const RiveFileData& b)
+                   { diffFileContents(a, b); });
+    }
+
+private:
+    void diffFileContents(const RiveFileData& before,
+                          const RiveFileData& after)
+    {
+        diffByName("artboard",
+                   before.artboards,
+                   after.artboards,
+                   [this](const auto& a, const auto& b)
+                   { diffShared(a, b, &RiveDiffer::diffArtboard); });
+        diffByName("asset",
+                   before.assets,
+                   after.assets,
+                   [this](const AssetInfo& a, const AssetInfo& b)
+                   {
+                       field("asset", "type", a.type, b.type);
+                       field("asset",
+                             "file_extension",
+                             a.fileExtension,
+                             b.fileExtension);
+                       field("asset", "id", a.assetId, b.assetId);
+                       field("asset", "cdn_uuid", a.cdnUuid, b.cdnUuid);
+                       field("asset",
+                             "cdn_base_url",
+                             a.cdnBaseUrl,
+                             b.cdnBaseUrl);
+                   });
+        diffByName("enum",
+                   before.enums,
+                   after.enums,
+                   [this](const auto& a, const auto& b)
+                   { diffShared(a, b, &RiveDiffer::diffEnum); });
+        diffByName("view_model",
+                   before.viewmodels,
+                   after.viewmodels,
+                   [this](const auto& a, const auto& b)
+                   { diffShared(a, b, &RiveDiffer::diffViewModel); });
+    }
+
+    // Matches the items of two lists by name, with repeated names matched
+    // in order, and compares each pair before reporting what was removed
+    // and added
+    template <typename T, typename Compare>
+    void diffByName(const char* kind,
+                    const std::vector<T>& before,
+                    const std::vector<T>& after,
+                    const Compare& compare)
+    {
+        std::unordered_map<std::string, std::vector<size_t>> afterIndices;
+        for (size_t i = 0; i < after.size(); i++)
+        {
+            afterIndices[nameOf(after[i])].push_back(i);
+        }
+        // How many items of each name have been matched so far
+        std::unordered_map<std::string, size_t> matchedCounts;
+        std::vector<bool> matched(after.size(), false);
+        for (const auto& item : before)
+        {
+            const std::string& name = nameOf(item);
+            auto indices = afterIndices.find(name);
+            size_t& count = matchedCounts[name];
+            if (indices == afterIndices.end() ||
+                count == indices->second.size())
+            {
+                report(RiveChange::Type::Removed, kind, name);
+                continue;
+            }
+            size_t index = indices->second[count++];
+            matched[index] = true;
+            m_path.push_back(name);
+            compare(item, after[index]);
+            m_path.pop_back();
+        }
+        for (size_t i = 0; i < after.size(); i++)
+        {
+            if (!matched[i])
+            {
+                report(RiveChange::Type::Added, kind, nameOf(after[i]));
+            }
+        }
+    }
+
+    // Interned structures are the same object when they're equal
+    template <typename T>
+    void diffShared(const std::shared_ptr<const T>& before,
+                    const std::shared_ptr<const T>& after,
+                    void (RiveDiffer::*diff)(const T&, const T&))
+    {
+        if (before != after)
+        {
+            (this->*diff)(*before, *after);
+        }
+    }
+
+    void diffArtboard(const ArtboardData& before, const ArtboardData& after)
+    {
+        diffByName("animation",
+                   before.animations,
+                   after.animations,
+                   [](const std::string&, const std::string&) {});
+        diffByName("state_machine",
+                   before.stateMachines,
+                   after.stateMachines,
+                   [this](const auto& a, const auto& b)
+                   {
+                       diffByName("input",
+                                  a.second,
+                                  b.second,
+                                  [this](const InputInfo& x,
+                                         const InputInfo& y)
+                                  {
+                                      field("input", "type", x.type, y.type);
+                                      field("input",
+                                            "default",
+                                            x.defaultValue,
+                                            y.defaultValue);
+                                  });
+                   });
+        diffByName("text_run",
+                   before.textValueRuns,
+                   after.textValueRuns,
+                   [this](const TextValueRunInfo& a, const TextValueRunInfo& b)
+                   {
+                       field("text_run",
+                             "default",
+                             a.defaultValue,
+                             b.defaultValue);
+                   });
+        diffByName("nested_text_run",
+                   before.nestedTextValueRuns,
+                   after.nestedTextValueRuns,
+                   [this](const NestedTextValueRunInfo& a,
+                          const NestedTextValueRunInfo& b)
+                   { field("nested_text_run", "path", a.path, b.path); });
+        diffByName("nested_artboard",
+                   before.nestedArtboards,
+                   after.nestedArtboards,
+                   [this](const NestedArtboardInfo& a,
+                          const NestedArtboardInfo& b)
+                   {
+                       field("nested_artboard",
+                             "artboard",
+                             a.artboardName,
+                             b.artboardName);
+                   });
+    }
+
+    void diffEnum(const EnumInfo& before, const EnumInfo& after)
+    {
+        diffByName("enum_value",
+                   before.values,
+                   after.values,
+                   [](const EnumValueInfo&, const EnumValueInfo&) {});
+    }
+
+    void diffViewModel(const ViewModelInfo& before, const ViewModelInfo& after)
+    {
+        diffByName("property",
+                   before.properties,
+                   after.properties,
+                   [this](const PropertyInfo& a, const PropertyInfo& b)
+                   {
+                       field("property", "type", a.type, b.type);
+                       field("property",
+                             "backing",
+                             a.backingName,
+                             b.backingName);
+                   });
+    }
+
+    void report(RiveChange::Type type,
+                const char* kind,
+                const std::string& name)
+    {
+        RiveChange change{type, kind, m_path};
+        change.path.push_back(name);
+        changes.push_back(std::move(change));
+    }
+
+    // Reports a field of the element at the current path if it changed
+    void field(const char* kind,
+               const char* name,
+               const std::string& before,
+               const std::string& after)
+    {
+        if (before != after)
+        {
+            changes.push_back({RiveChange::Type::Changed,
+                               kind,
+                               m_path,
+                               name,
+                               before,
+                               after});
+        }
+    }
+
+    std::vector<std::string> m_path;
+};
+
+std::vector<RiveChange> diffRiveFile(const RiveFileData& before,
+                                     const RiveFileData& after)
+{
+    RiveDiffer differ;
+    differ.diffFile(before, after);
+    return std::move(differ.changes);
+}
+
+std::vector<RiveChange> diffRiveFiles(const std::vector<RiveFileData>& before,
+                                      const std::vector<RiveFileData>& after)
+{
+    RiveDiffer differ;
+    differ.diffFiles(before, after);
+    return std::move(differ.changes);
+}
+
+static const char* changeTypeName(RiveChange::Type type)
+{
+    switch (type)
+    {
+        case RiveChange::Type::Added:
+            return "added";
+        case RiveChange::Type::Removed:
+            return "removed";
+        case RiveChange::Type::Changed:
+            return "changed";
+    }
+    return "";
+}
+
+static void appendJsonString(std::string& output, const std::string& value)
+{
+    output += '"';
+    appendJsonEscaped(output, value);
+    output += '"';
+}
+
+void writeChanges(std::ostream& output, const std::vector<RiveChange>& changes)
+{
+    std::string line;
+    for (const auto& change : changes)
+    {
+        line = "{\"change\":\"";
+        line += changeTypeName(change.type);
+        line += "\",\"kind\":";
+        appendJsonString(line, change.kind);
+        line += ",\"path\":[";
+        for (size_t i = 0; i < change.path.size(); i++)
+        {
+            if (i > 0)
+            {
+                line += ',';
+            }
+            appendJsonString(line, change.path[i]);
+        }
+        line += ']';
+        if (change.type == RiveChange::Type::Changed)
+        {
+            line += ",\"field\":";
+            appendJsonString(line, change.field);
+            line += ",\"before\":";
+            appendJsonString(line, change.before);
+            line += ",\"after\":";
+            appendJsonString(line, change.after);
+        }
+        line += "}\n";
+        output << line;
+    }
+}
@@ -0,0 +1,509 @@
+#include "rive_extractor.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <unordered_set>
+#include <utility>
+
+#include "naming.h"
+#include "parallel_for.h"
+#include "rive/animation/linear_animation_instance.hpp"
+#include "rive/animation/state_machine_input_instance.hpp"
+#include "rive/animation/state_machine_instance.hpp"
+#include "rive/assets/audio_asset.hpp"
+#include "rive/assets/font_asset.hpp"
+#include "rive/assets/image_asset.hpp"
+#include "rive/file.hpp"
+#include "rive/nested_artboard.hpp"
+#include "rive/generated/animation/state_machine_bool_base.hpp"
+#include "rive/generated/animation/state_machine_number_base.hpp"
+#include "rive/generated/animation/state_machine_trigger_base.hpp"
+#include "rive/viewmodel/data_enum.hpp"
+#include "rive/viewmodel/data_enum_value.hpp"
+#include "rive/viewmodel/runtime/viewmodel_runtime.hpp"
+#include "rive/viewmodel/viewmodel_property_enum.hpp"
+#include "utils/no_op_factory.hpp"
+
+static std::optional<std::vector<uint8_t>> readFile(const char name[])
+{
+    FILE* f = fopen(name, "rb");
+    if (!f)
+    {
+        return std::nullopt;
+    }
+
+    fseek(f, 0, SEEK_END);
+    auto length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    std::vector<uint8_t> bytes(length);
+    bool read = fread(bytes.data(), 1, length, f) == length;
+    fclose(f);
+    if (!read)
+    {
+        return std::nullopt;
+    }
+    return bytes;
+}
+
+static std::vector<std::string> getAnimationsFromArtboard(
+    rive::ArtboardInstance* artboard)
+{
+    std::vector<std::string> animations;
+    auto animationCount = artboard->animationCount();
+    for (int i = 0; i < animationCount; i++)
+    {
+        auto animation = artboard->animationAt(i);
+        animations.push_back(animation->name());
+    }
+    return animations;
+}
+
+static std::vector<std::pair<std::string, std::vector<InputInfo>>>
+getStateMachinesFromArtboard(rive::ArtboardInstance* artboard)
+{
+    std::vector<std::pair<std::string, std::vector<InputInfo>>> stateMachines;
+    auto stateMachineCount = artboard->stateMachineCount();
+    for (int i = 0; i < stateMachineCount; i++)
+    {
+        auto stateMachine = artboard->stateMachineAt(i);
+        std::string stateMachineName = stateMachine->name();
+
+        std::vector<InputInfo> inputs;
+        auto inputCount = stateMachine->inputCount();
+        for (int j = 0; j < inputCount; j++)
+        {
+            auto input = stateMachine->input(j);
+
+            std::string inputType;
+            std::string defaultValue;
+
+            // Determine the input type and default value
+            switch (input->inputCoreType())
+            {
+                case rive::StateMachineNumberBase::typeKey:
+                {
+                    auto smiNumberInput = static_cast<rive::SMINumber*>(input);
+                    inputType = "number";
+                    defaultValue = std::to_string(smiNumberInput->value());
+                    break;
+                }
+                case rive::StateMachineTriggerBase::typeKey:
+                {
+                    inputType = "trigger";
+                    defaultValue = "false";
+                    break;
+                }
+                case rive::StateMachineBoolBase::typeKey:
+                {
+                    auto smiBoolInput = static_cast<rive::SMIBool*>(input);
+                    inputType = "boolean";
+                    defaultValue = smiBoolInput->value() ? "true" : "false";
+                    break;
+                }
+                default:
+                {
+                    inputType = "unknown";
+                    defaultValue = "";
+                    break;
+                }
+            }
+
+            inputs.push_back(
+                {input->name(), std::move(inputType), std::move(defaultValue)});
+        }
+
+        stateMachines.emplace_back(std::move(stateMachineName),
+                                   std::move(inputs));
+    }
+    return stateMachines;
+}
+
+template <typename T = rive::Component>
+void findAll(std::vector<T*>& results, rive::ArtboardInstance* artboard)
+{
+    for (auto object : artboard->objects())
+    {
+        if (object != nullptr && object->is<T>())
+        {
+            results.push_back(static_cast<T*>(object));
+        }
+    }
+}
+
+static std::vector<TextValueRunInfo> getTextValueRunsFromArtboard(
+    rive::ArtboardInstance* artboard)
+{
+    std::vector<rive::TextValueRun*> textValueRuns;
+    std::vector<TextValueRunInfo> textValueRunsInfo;
+
+    findAll<rive::TextValueRun>(textValueRuns, artboard);
+
+    for (auto textValueRun : textValueRuns)
+    {
+        if (!textValueRun->name().empty())
+        {
+            textValueRunsInfo.push_back(
+                {textValueRun->name(), textValueRun->text()});
+        }
+    }
+    return textValueRunsInfo;
+}
+
+static std::vector<NestedTextValueRunInfo>
+getNestedTextValueRunPathsFromArtboard(
+    rive::ArtboardInstance* artboard,
+    const std::string& currentPath = "")
+{
+    std::vector<NestedTextValueRunInfo> nestedTextValueRunsInfo;
+    auto count = artboard->nestedArtboards().size();
+
+    if (!currentPath.empty())
+    {
+        auto textRuns = getTextValueRunsFromArtboard(artboard);
+        for (auto& textRun : textRuns)
+        {
+            nestedTextValueRunsInfo.push_back(
+                {std::move(textRun.name), currentPath});
+        }
+    }
+
+    // Recursively process nested artboards
+    for (int i = 0; i < count; i++)
+    {
+        auto nested = artboard->nestedArtboards()[i];
+        auto nestedName = nested->name();
+        if (!nestedName.empty())
+        {
+            // Only process nested artboards that have an exported name
+            std::string newPath = currentPath.empty()
+                                       ? nested->name()
+                                       : currentPath + "/" + nested->name();
+
+            auto nestedResults = getNestedTextValueRunPathsFromArtboard(
+                nested->artboardInstance(),
+                newPath);
+            nestedTextValueRunsInfo.insert(
+                nestedTextValueRunsInfo.end(),
+                std::make_move_iterator(nestedResults.begin()),
+                std::make_move_iterator(nestedResults.end()));
+        }
+    }
+
+    return nestedTextValueRunsInfo;
+}
+
+// The artboard's named nested artboards, whose own runs and nested
+// artboards are in the artboards they're instances of, so each artboard's
+// runs are listed once however many paths lead to it
+static std::vector<NestedArtboardInfo> getNestedArtboardsFromArtboard(
+    rive::ArtboardInstance* artboard,
+    size_t artboardCount)
+{
+    std::vector<NestedArtboardInfo> nestedArtboardsInfo;
+    for (auto nested : artboard->nestedArtboards())
+    {
+        // Only nested artboards that have an exported name are reachable
+        if (nested->name().empty() || !nested->artboardInstance() ||
+            nested->artboardId() >= artboardCount)
+        {
+            continue;
+        }
+        nestedArtboardsInfo.push_back({nested->name(),
+                                       nested->artboardInstance()->name(),
+                                       nested->artboardId()});
+    }
+    return nestedArtboardsInfo;
+}
+
+static std::vector<AssetInfo> getAssetsFromFile(rive::File* file)
+{
+    std::vector<AssetInfo> assetsInfo;
+    std::unordered_set<std::string> usedAssetNames;
+
+    auto assets = file->assets();
+    for (auto asset : assets)
+    {
+        std::string assetType;
+        switch (asset->coreType())
+        {
+            case rive::ImageAsset::typeKey:
+                assetType = "image";
+                break;
+            case rive::FontAsset::typeKey:
+                assetType = "font";
+                break;
+            case rive::AudioAsset::typeKey:
+                assetType = "audio";
+                break;
+            default:
+                assetType = "unknown";
+                break;
+        }
+
+        auto assetName = asset->name();
+        auto uniqueAssetName = makeUnique(assetName, usedAssetNames);
+
+        assetsInfo.push_back(AssetInfo{std::move(uniqueAssetName),
+                                       std::move(assetType),
+                                       asset->fileExtension(),
+                                       std::to_string(asset->assetId()),
+                                       asset->cdnUuidStr(),
+                                       asset->cdnBaseUrl()});
+    }
+    return assetsInfo;
+}
+
+static std::string dataTypeToString(rive::DataType type)
+{
+    switch (type)
+    {
+        case rive::DataType::none:
+            return "none";
+        case rive::DataType::string:
+            return "string";
+        case rive::DataType::number:
+            return "number";
+        case rive::DataType::boolean:
+            return "boolean";
+        case rive::DataType::color:
+            return "color";
+        case rive::DataType::list:
+            return "list";
+        case rive::DataType::enumType:
+            return "enum";
+        case rive::DataType::trigger:
+            return "trigger";
+        case rive::DataType::viewModel:
+            return "viewModel";
+        case rive::DataType::integer:
+            return "integer";
+        case rive::DataType::symbolListIndex:
+            return "symbolListIndex";
+        case rive::DataType::assetImage:
+            return "assetImage";
+        default:
+            return "unknown";
+    }
+}
+
+static ViewModelInfo getViewModelInfo(rive::File* riveFile,
+                                      rive::ViewModelRuntime* viewModel)
+{
+    ViewModelInfo viewModelInfo;
+    viewModelInfo.name = viewModel->name();
+    auto propertiesData = viewModel->properties();
+    for (const auto& property : propertiesData)
+    {
+        if (property.type == rive::DataType::viewModel)
+        {
+            // TODO: this is a hack
+            auto nestedViewModel =
+                viewModel->createInstance()->propertyViewModel(property.name);
+            auto vm = nestedViewModel->instance()->viewModel();
+            viewModelInfo.properties.push_back(
+                {property.name, dataTypeToString(property.type), vm->name()});
+        }
+        else if (property.type == rive::DataType::enumType)
+        {
+            // TODO: this is a hack
+            auto vmi = riveFile->createViewModelInstance(viewModel->name());
+            auto enum_instance = static_cast<rive::ViewModelInstanceEnum*>(
+                vmi->propertyValue(property.name));
+            auto enumProperty = enum_instance->viewModelProperty()
+                                    ->as<rive::ViewModelPropertyEnum>();
+            auto enumName = enumProperty->dataEnum()->enumName();
+            viewModelInfo.properties.push_back(
+                {property.name,
+                 dataTypeToString(property.type),
+                 std::move(enumName)});
+        }
+        else
+        {
+            viewModelInfo.properties.push_back(
+                {property.name, dataTypeToString(property.type)});
+        }
+    }
+    return viewModelInfo;
+}
+
+// The artboard's camelCase name is made unique once every artboard of the
+// file is extracted
+static ArtboardData getArtboardData(rive::File* riveFile,
+                                    size_t index,
+                                    const ExtractionStages& stages)
+{
+    auto artboard = riveFile->artboardAt(index);
+    std::string artboardName = artboard->name();
+
+    std::string artboardPascalCase = toPascalCase(artboardName);
+    std::string artboardCameCase = toCamelCase(artboardName);
+    std::string artboardSnakeCase = toSnakeCase(artboardName);
+    std::string artboardKebabCase = toKebabCase(artboardName);
+
+    std::vector<std::string> animations;
+    if (stages.animations)
+    {
+        animations = getAnimationsFromArtboard(artboard.get());
+    }
+    std::vector<std::pair<std::string, std::vector<InputInfo>>> stateMachines;
+    if (stages.stateMachines)
+    {
+        stateMachines = getStateMachinesFromArtboard(artboard.get());
+    }
+    std::vector<TextValueRunInfo> textValueRuns;
+    if (stages.textValueRuns)
+    {
+        textValueRuns = getTextValueRunsFromArtboard(artboard.get());
+    }
+    std::vector<NestedTextValueRunInfo> nestedTextValueRuns;
+    if (stages.nestedTextValueRuns)
+    {
+        nestedTextValueRuns =
+            getNestedTextValueRunPathsFromArtboard(artboard.get());
+    }
+    std::vector<NestedArtboardInfo> nestedArtboards;
+    if (stages.nestedArtboards)
+    {
+        nestedArtboards = getNestedArtboardsFromArtboard(
+            artboard.get(),
+            riveFile->artboardCount());
+    }
+
+    return {std::move(artboardName),
+            std::move(artboardPascalCase),
+            std::move(artboardCameCase),
+            std::move(artboardSnakeCase),
+            std::move(artboardKebabCase),
+            std::move(animations),
+            std::move(stateMachines),
+            std::move(textValueRuns),
+            std::move(nestedTextValueRuns),
+            std::move(nestedArtboards)};
+}
+
+// FNV-1a, which generated code can compute over the bytes it loads
+static uint64_t fingerprintOf(const uint8_t* bytes, size_t size)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::optional<RiveFileData> processRiveFile(
+    const std::string& riveFilePath,
+    StructureInterner& interner,
+    const ExtractionStages& stages)
+{
+    auto bytes = readFile(riveFilePath.c_str());
+    if (!bytes)
+    {
+        std::cerr << "Error: Failed to read Rive file: " << riveFilePath
+                  << std::endl;
+        return std::nullopt;
+    }
+    return processRiveBytes(riveFilePath,
+                            bytes->data(),
+                            bytes->size(),
+                            interner,
+                            stages);
+}
+
+std::optional<RiveFileData> processRiveBytes(const std::string& riveFilePath,
+                                             const uint8_t* bytes,
+                                             size_t size,
+                                             StructureInterner& interner,
+                                             const ExtractionStages& stages)
+{
+    // Check if the file is empty
+    if (size == 0)
+    {
+        std::cerr << "Error: Rive file is empty: " << riveFilePath
+                  << std::endl;
+        return std::nullopt;
+    }
+
+    static rive::NoOpFactory gFactory;
+    auto riveFile = rive::File::import(rive::Span<const uint8_t>(bytes, size),
+                                       &gFactory);
+    if (!riveFile)
+    {
+        std::cerr << "Error: Failed to parse Rive file: " << riveFilePath
+                  << std::endl;
+        return std::nullopt;
+    }
+
+    std::filesystem::path path(riveFilePath);
+    std::string fileNameWithoutExtension = path.stem().string();
+    RiveFileData fileData;
+    fileData.rivPascalCase = toPascalCase(fileNameWithoutExtension);
+    fileData.rivCameCase = toCamelCase(fileNameWithoutExtension);
+    fileData.riveSnakeCase = toSnakeCase(fileNameWithoutExtension);
+    fileData.rivKebabCase = toKebabCase(fileNameWithoutExtension);
+    fileData.rivName = std::move(fileNameWithoutExtension);
+    fileData.fingerprint = fingerprintOf(bytes, size);
+    if (stages.assets)
+    {
+        fileData.assets = getAssetsFromFile(riveFile.get());
+    }
+
+    // Process enums
+    if (stages.enums)
+    {
+        const auto& fileEnums = riveFile->enums();
+        for (auto* dataEnum : fileEnums)
+        {
+            if (dataEnum)
+            {
+                EnumInfo enumInfo;
+                enumInfo.name = dataEnum->enumName();
+                const auto& values = dataEnum->values();
+                for (const auto* value : values)
+                {
+                    enumInfo.values.push_back({value->key()});
+                }
+                fileData.enums.push_back(interner.intern(std::move(enumInfo)));
+            }
+        }
+    }
+
+    // View models are extracted on this thread, since creating their
+    // instances goes through caches on the file. Artboards are then extracted
+    // in parallel, each into its own slot, so that one large file is spread
+    // over the cores.
+    size_t viewModelCount = stages.viewModels ? riveFile->viewModelCount() : 0;
+    for (size_t i = 0; i < viewModelCount; i++)
+    {
+        if (auto viewModel = riveFile->viewModelByIndex(i))
+        {
+            fileData.viewmodels.push_back(interner.intern(
+                getViewModelInfo(riveFile.get(), viewModel)));
+        }
+    }
+
+    size_t artboardCount = stages.artboards ? riveFile->artboardCount() : 0;
+    std::vector<ArtboardData> artboards(artboardCount);
+    parallelFor(artboardCount,
+                [&](size_t i)
+                {
+                    artboards[i] =
+                        getArtboardData(riveFile.get(), i, stages);
+                });
+
+    // Ensure unique artboard variable names, in the artboards' order so the
+    // suffixes don't depend on which finished first
+    std::unordered_set<std::string> usedArtboardNames;
+    for (auto& artboard : artboards)
+    {
+        artboard.artboardCameCase =
+            makeUnique(artboard.artboardCameCase, usedArtboardNames);
+        fileData.artboards.push_back(interner.intern(std::move(artboard)));
+    }
+
+    return fileData;
+}
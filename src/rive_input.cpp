@@ -0,0 +1,282 @@
+#include "rive_input.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+static constexpr size_t tarBlockSize = 512;
+
+// Offsets and lengths of the ustar header fields that are used
+static constexpr size_t tarNameOffset = 0;
+static constexpr size_t tarNameLength = 100;
+static constexpr size_t tarSizeOffset = 124;
+static constexpr size_t tarSizeLength = 12;
+static constexpr size_t tarChecksumOffset = 148;
+static constexpr size_t tarChecksumLength = 8;
+static constexpr size_t tarTypeOffset = 156;
+static constexpr size_t tarMagicOffset = 257;
+static constexpr size_t tarPrefixOffset = 345;
+static constexpr size_t tarPrefixLength = 155;
+
+bool isStdinPath(const std::string& path) { return path == "-"; }
+
+bool isTarPath(const std::string& path)
+{
+    return std::filesystem::path(path).extension() == ".tar";
+}
+
+std::optional<RiveInput> readStdin()
+{
+#ifdef _WIN32
+    // stdin starts in text mode, which would translate line endings
+    _setmode(_fileno(stdin), _O_BINARY);
+#endif
+
+    RiveInput input;
+    input.path = "stdin";
+    uint8_t buffer[64 * 1024];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), stdin)) > 0)
+    {
+        input.bytes.insert(input.bytes.end(), buffer, buffer + read);
+    }
+    if (ferror(stdin))
+    {
+        std::cerr << "Error: Failed to read Rive file from stdin" << std::endl;
+        return std::nullopt;
+    }
+    return input;
+}
+
+// A NUL terminated header field, which may fill its whole length
+static std::string tarString(const char* field, size_t length)
+{
+    size_t size = 0;
+    while (size < length && field[size] != '\0')
+    {
+        size++;
+    }
+    return std::string(field, size);
+}
+
+// A numeric header field: octal padded with spaces or NULs, or big-endian
+// base-256 with the high bit set for values octal can't hold
+static std::optional<uint64_t> tarNumber(const char* field, size_t length)
+{
+    const auto* bytes = reinterpret_cast<const unsigned char*>(field);
+    if (bytes[0] & 0x80)
+    {
+        uint64_t value = bytes[0] & 0x7f;
+        for (size_t i = 1; i < length; i++)
+        {
+            value = (value << 8) | bytes[i];
+        }
+        return value;
+    }
+
+    size_t i = 0;
+    while (i < length && field[i] == ' ')
+    {
+        i++;
+    }
+    uint64_t value = 0;
+    for (; i < length && field[i] >= '0' && field[i] <= '7'; i++)
+    {
+        value = value * 8 + (field[i] - '0');
+    }
+    for (; i < length; i++)
+    {
+        if (field[i] != ' ' && field[i] != '\0')
+        {
+            return std::nullopt;
+        }
+    }
+    return value;
+}
+
+// The checksum is the sum of the header's bytes with the checksum field
+// itself counted as spaces. Some old writers summed signed chars.
+static bool tarChecksumMatches(const char* header)
+{
+    auto expected = tarNumber(header + tarChecksumOffset, tarChecksumLength);
+    if (!expected)
+    {
+        return false;
+    }
+    uint64_t unsignedSum = 0;
+    int64_t signedSum = 0;
+    for (size_t i = 0; i < tarBlockSize; i++)
+    {
+        bool inChecksum = i >= tarChecksumOffset &&
+                          i < tarChecksumOffset + tarChecksumLength;
+        char c = inChecksum ? ' ' : header[i];
+        unsignedSum += static_cast<unsigned char>(c);
+        signedSum += static_cast<signed char>(c);
+    }
+    return *expected == unsignedSum ||
+           static_cast<int64_t>(*expected) == signedSum;
+}
+
+// The "path" record of a pax extended header, or empty if it has none.
+// Records are "<length> <key>=<value>\n", with the length counting the
+// whole record.
+static std::string paxPath(const std::string& records)
+{
+    size_t start = 0;
+    while (start < records.size())
+    {
+        size_t space = records.find(' ', start);
+        if (space == std::string::npos)
+        {
+            break;
+        }
+        size_t length = std::strtoul(records.c_str() + start, nullptr, 10);
+        if (length == 0 || start + length > records.size())
+        {
+            break;
+        }
+        std::string record =
+            records.substr(space + 1, start + length - space - 2);
+        if (record.compare(0, 5, "path=") == 0)
+        {
+            return record.substr(5);
+        }
+        start += length;
+    }
+    return std::string();
+}
+
+static bool skipBytes(std::istream& stream, uint64_t count)
+{
+    char buffer[tarBlockSize];
+    while (count > 0)
+    {
+        auto chunk = static_cast<std::streamsize>(
+            std::min<uint64_t>(count, sizeof(buffer)));
+        if (!stream.read(buffer, chunk))
+        {
+            return false;
+        }
+        count -= chunk;
+    }
+    return true;
+}
+
+// Appends `count` bytes of the stream to `bytes` a chunk at a time, so a
+// size from a corrupt header can't allocate more than the stream holds
+static bool readBytes(std::istream& stream,
+                      uint64_t count,
+                      std::vector<uint8_t>& bytes)
+{
+    char buffer[64 * 1024];
+    while (count > 0)
+    {
+        auto chunk = static_cast<std::streamsize>(
+            std::min<uint64_t>(count, sizeof(buffer)));
+        if (!stream.read(buffer, chunk))
+        {
+            return false;
+        }
+        bytes.insert(bytes.end(), buffer, buffer + chunk);
+        count -= chunk;
+    }
+    return true;
+}
+
+bool readTarArchive(std::istream& stream,
+                    const std::string& archivePath,
+                    const std::function<void(RiveInput&&)>& onEntry)
+{
+    const auto malformed = [&]()
+    {
+        std::cerr << "Error: Malformed tar archive: " << archivePath
+                  << std::endl;
+        return false;
+    };
+
+    // Set by a GNU long name or pax header for the entry that follows it
+    std::string nextName;
+    char header[tarBlockSize];
+    while (true)
+    {
+        if (!stream.read(header, tarBlockSize))
+        {
+            // The end-of-archive blocks are optional in practice
+            return stream.gcount() == 0 ? true : malformed();
+        }
+        bool allZero = true;
+        for (char c : header)
+        {
+            allZero = allZero && c == '\0';
+        }
+        if (allZero)
+        {
+            return true;
+        }
+
+        auto size = tarNumber(header + tarSizeOffset, tarSizeLength);
+        // Base-256 sizes can be large enough for the padding to overflow
+        if (!tarChecksumMatches(header) || !size ||
+            *size > UINT64_MAX - tarBlockSize)
+        {
+            return malformed();
+        }
+        uint64_t padding = (tarBlockSize - *size % tarBlockSize) % tarBlockSize;
+
+        std::string name = tarString(header + tarNameOffset, tarNameLength);
+        std::string prefix =
+            tarString(header + tarPrefixOffset, tarPrefixLength);
+        if (std::memcmp(header + tarMagicOffset, "ustar", 5) == 0 &&
+            !prefix.empty())
+        {
+            name = prefix + "/" + name;
+        }
+        if (!nextName.empty())
+        {
+            name = std::move(nextName);
+            nextName.clear();
+        }
+
+        char type = header[tarTypeOffset];
+        bool isFile = type == '0' || type == '\0' || type == '7';
+        bool isRive = isFile && std::filesystem::path(name).extension() ==
+                                    ".riv";
+        if (type == 'L' || type == 'x' || isRive)
+        {
+            std::vector<uint8_t> contents;
+            if (!readBytes(stream, *size, contents) ||
+                !skipBytes(stream, padding))
+            {
+                return malformed();
+            }
+            if (type == 'L')
+            {
+                nextName = tarString(reinterpret_cast<char*>(contents.data()),
+                                     contents.size());
+            }
+            else if (type == 'x')
+            {
+                nextName = paxPath(std::string(contents.begin(),
+                                               contents.end()));
+            }
+            else
+            {
+                onEntry({archivePath + "/" + name, std::move(contents)});
+            }
+        }
+        else if (!skipBytes(stream, *size + padding))
+        {
+            return malformed();
+        }
+    }
+}
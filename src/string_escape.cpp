@@ -0,0 +1,467 @@
+#include "string_escape.h"
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ESCAPE_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX2 is selected at runtime, which needs per-function target attributes
+#if defined(ESCAPE_SSE2) && defined(__GNUC__)
+#define ESCAPE_AVX2
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int countTrailingZeros(uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Each escaper is described by a policy telling which bytes need escaping,
+// with one test per instruction set that all have to agree.
+
+// Control characters, DEL, bytes >= 0x80, quotes and backslashes. Bytes
+// >= 0x80 are negative when compared as signed, which catches them together
+// with the control characters.
+struct SanitizePolicy
+{
+    static bool scalar(unsigned char c)
+    {
+        return c < 0x20 || c >= 0x7f || c == '"' || c == '\\';
+    }
+#ifdef ESCAPE_SSE2
+    static __m128i sse2(__m128i v)
+    {
+        __m128i special =
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                         _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+        special = _mm_or_si128(special, _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7f)));
+        return _mm_or_si128(special, _mm_cmplt_epi8(v, _mm_set1_epi8(0x20)));
+    }
+#endif
+#ifdef ESCAPE_AVX2
+    AVX2_TARGET static __m256i avx2(__m256i v)
+    {
+        __m256i special =
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')));
+        special = _mm256_or_si256(special,
+                                  _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7f)));
+        return _mm256_or_si256(special,
+                               _mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), v));
+    }
+#endif
+};
+
+struct HtmlPolicy
+{
+    static bool scalar(unsigned char c)
+    {
+        return c == '&' || c == '<' || c == '>' || c == '"' || c == '\'';
+    }
+#ifdef ESCAPE_SSE2
+    static __m128i sse2(__m128i v)
+    {
+        __m128i special =
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('&')),
+                         _mm_cmpeq_epi8(v, _mm_set1_epi8('<')));
+        special = _mm_or_si128(special, _mm_cmpeq_epi8(v, _mm_set1_epi8('>')));
+        special = _mm_or_si128(special, _mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+        return _mm_or_si128(special, _mm_cmpeq_epi8(v, _mm_set1_epi8('\'')));
+    }
+#endif
+#ifdef ESCAPE_AVX2
+    AVX2_TARGET static __m256i avx2(__m256i v)
+    {
+        __m256i special =
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('&')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('<')));
+        special = _mm256_or_si256(special,
+                                  _mm256_cmpeq_epi8(v, _mm256_set1_epi8('>')));
+        special = _mm256_or_si256(special,
+                                  _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')));
+        return _mm256_or_si256(special,
+                               _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\'')));
+    }
+#endif
+};
+
+// Control characters, quotes and backslashes. UTF-8 bytes pass through, so
+// the control character test is unsigned: v <= 0x1f iff min(v, 0x1f) == v.
+struct JsonPolicy
+{
+    static bool scalar(unsigned char c)
+    {
+        return c < 0x20 || c == '"' || c == '\\';
+    }
+#ifdef ESCAPE_SSE2
+    static __m128i sse2(__m128i v)
+    {
+        __m128i special =
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                         _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+        return _mm_or_si128(
+            special,
+            _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1f)), v));
+    }
+#endif
+#ifdef ESCAPE_AVX2
+    AVX2_TARGET static __m256i avx2(__m256i v)
+    {
+        __m256i special =
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')));
+        return _mm256_or_si256(
+            special,
+            _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1f)), v));
+    }
+#endif
+};
+
+// Scanners return the offset of the first byte needing an escape, or `size`
+
+template <typename Policy>
+static size_t scanScalar(const char* data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        if (Policy::scalar(static_cast<unsigned char>(data[i])))
+        {
+            return i;
+        }
+    }
+    return size;
+}
+
+// The vector scanners finish with one overlapping load ending at the last
+// byte, ignoring the lanes that were already checked, rather than a scalar
+// loop over the remainder.
+
+#ifdef ESCAPE_SSE2
+template <typename Policy>
+static size_t scanSSE2(const char* data, size_t size)
+{
+    if (size < 16)
+    {
+        return scanScalar<Policy>(data, size);
+    }
+
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int mask = _mm_movemask_epi8(Policy::sse2(v));
+        if (mask != 0)
+        {
+            return i + countTrailingZeros(static_cast<uint32_t>(mask));
+        }
+    }
+    if (i < size)
+    {
+        size_t start = size - 16;
+        __m128i v =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + start));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(Policy::sse2(v)))
+                        >> (i - start) << (i - start);
+        if (mask != 0)
+        {
+            return start + countTrailingZeros(mask);
+        }
+    }
+    return size;
+}
+#endif
+
+#ifdef ESCAPE_AVX2
+// Everything is inlined here: calling into the non-VEX SSE2 scanner with
+// the upper halves of the YMM registers in use would stall on the
+// transition.
+template <typename Policy>
+AVX2_TARGET static size_t scanAVX2(const char* data, size_t size)
+{
+    if (size < 32)
+    {
+        if (size < 16)
+        {
+            return scanScalar<Policy>(data, size);
+        }
+        // One or two (overlapping) 16 byte vectors
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        int mask = _mm_movemask_epi8(Policy::sse2(v));
+        if (mask != 0)
+        {
+            return countTrailingZeros(static_cast<uint32_t>(mask));
+        }
+        size_t start = size - 16;
+        v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + start));
+        mask = _mm_movemask_epi8(Policy::sse2(v));
+        return mask != 0
+                   ? start + countTrailingZeros(static_cast<uint32_t>(mask))
+                   : size;
+    }
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        __m256i v =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        int mask = _mm256_movemask_epi8(Policy::avx2(v));
+        if (mask != 0)
+        {
+            return i + countTrailingZeros(static_cast<uint32_t>(mask));
+        }
+    }
+    if (i < size)
+    {
+        size_t start = size - 32;
+        __m256i v =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + start));
+        uint32_t mask =
+            static_cast<uint32_t>(_mm256_movemask_epi8(Policy::avx2(v))) >>
+            (i - start) << (i - start);
+        if (mask != 0)
+        {
+            return start + countTrailingZeros(mask);
+        }
+    }
+    return size;
+}
+#endif
+
+using ScanFunction = size_t (*)(const char*, size_t);
+
+struct Scanners
+{
+    ScanFunction sanitize;
+    ScanFunction html;
+    ScanFunction json;
+};
+
+static bool kernelSupported(EscapeKernel kernel)
+{
+    switch (kernel)
+    {
+        case EscapeKernel::Scalar:
+            return true;
+        case EscapeKernel::SSE2:
+#ifdef ESCAPE_SSE2
+            return true;
+#else
+            return false;
+#endif
+        case EscapeKernel::AVX2:
+#ifdef ESCAPE_AVX2
+            // Required as this also runs during static initialization
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+static Scanners scannersFor(EscapeKernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef ESCAPE_AVX2
+        case EscapeKernel::AVX2:
+            return {scanAVX2<SanitizePolicy>,
+                    scanAVX2<HtmlPolicy>,
+                    scanAVX2<JsonPolicy>};
+#endif
+#ifdef ESCAPE_SSE2
+        case EscapeKernel::SSE2:
+            return {scanSSE2<SanitizePolicy>,
+                    scanSSE2<HtmlPolicy>,
+                    scanSSE2<JsonPolicy>};
+#endif
+        default:
+            return {scanScalar<SanitizePolicy>,
+                    scanScalar<HtmlPolicy>,
+                    scanScalar<JsonPolicy>};
+    }
+}
+
+static EscapeKernel bestKernel()
+{
+    if (kernelSupported(EscapeKernel::AVX2))
+    {
+        return EscapeKernel::AVX2;
+    }
+    if (kernelSupported(EscapeKernel::SSE2))
+    {
+        return EscapeKernel::SSE2;
+    }
+    return EscapeKernel::Scalar;
+}
+
+static EscapeKernel gKernel = bestKernel();
+static Scanners gScanners = scannersFor(gKernel);
+
+EscapeKernel escapeKernel() { return gKernel; }
+
+bool setEscapeKernel(EscapeKernel kernel)
+{
+    if (!kernelSupported(kernel))
+    {
+        return false;
+    }
+    gKernel = kernel;
+    gScanners = scannersFor(kernel);
+    return true;
+}
+
+// Copies `input` to `output`, bulk-copying the runs found by `scan` and
+// passing each byte that needs escaping to `escape`
+template <typename Escape>
+static void appendEscaped(std::string& output,
+                          const std::string& input,
+                          ScanFunction scan,
+                          Escape escape)
+{
+    const char* data = input.data();
+    size_t size = input.size();
+    size_t position = 0;
+    while (position < size)
+    {
+        size_t special = position + scan(data + position, size - position);
+        output.append(data + position, special - position);
+        if (special == size)
+        {
+            break;
+        }
+        escape(output, static_cast<unsigned char>(data[special]));
+        position = special + 1;
+    }
+}
+
+static const char* hexDigits = "0123456789abcdef";
+
+static void appendUnicodeEscape(std::string& output, unsigned char c)
+{
+    output += "\\u00";
+    output += hexDigits[c >> 4];
+    output += hexDigits[c & 0xf];
+}
+
+std::string sanitizeString(const std::string& input)
+{
+    size_t special = gScanners.sanitize(input.data(), input.size());
+    if (special == input.size())
+    {
+        return input;
+    }
+
+    std::string output;
+    output.reserve(input.size() + input.size() / 4 + 8);
+    appendEscaped(output,
+                  input,
+                  gScanners.sanitize,
+                  [](std::string& output, unsigned char c) {
+                      switch (c)
+                      {
+                          case '\n':
+                              output += "\\n";
+                              break;
+                          case '\r':
+                              output += "\\r";
+                              break;
+                          case '\t':
+                              output += "\\t";
+                              break;
+                          case '\"':
+                              output += "\\\"";
+                              break;
+                          case '\\':
+                              output += "\\\\";
+                              break;
+                          default:
+                              appendUnicodeEscape(output, c);
+                      }
+                  });
+    return output;
+}
+
+std::string htmlEscape(const std::string& input)
+{
+    size_t special = gScanners.html(input.data(), input.size());
+    if (special == input.size())
+    {
+        return input;
+    }
+
+    std::string output;
+    output.reserve(input.size() + input.size() / 4 + 8);
+    appendHtmlEscaped(output, input);
+    return output;
+}
+
+void appendHtmlEscaped(std::string& output, const std::string& input)
+{
+    appendEscaped(output,
+                  input,
+                  gScanners.html,
+                  [](std::string& output, unsigned char c) {
+                      switch (c)
+                      {
+                          case '&':
+                              output += "&amp;";
+                              break;
+                          case '<':
+                              output += "&lt;";
+                              break;
+                          case '>':
+                              output += "&gt;";
+                              break;
+                          case '\"':
+                              output += "&quot;";
+                              break;
+                          default:
+                              output += "&apos;";
+                      }
+                  });
+}
+
+void appendJsonEscaped(std::string& output, const std::string& input)
+{
+    appendEscaped(output,
+                  input,
+                  gScanners.json,
+                  [](std::string& output, unsigned char c) {
+                      switch (c)
+                      {
+                          case '"':
+                              output += "\\\"";
+                              break;
+                          case '\\':
+                              output += "\\\\";
+                              break;
+                          case '\n':
+                              output += "\\n";
+                              break;
+                          case '\r':
+                              output += "\\r";
+                              break;
+                          case '\t':
+                              output += "\\t";
+                              break;
+                          default:
+                              appendUnicodeEscape(output, c);
+                      }
+                  });
+}
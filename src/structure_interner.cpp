@@ -0,0 +1,239 @@
+#include "structure_interner.h"
+
+#include <string>
+
+// FNV-1a over every field, with lengths mixed in so that field boundaries
+// can't shift between otherwise equal concatenations
+class ContentHasher
+{
+public:
+    void add(const std::string& str)
+    {
+        add(str.size());
+        for (unsigned char c : str)
+        {
+            m_hash = (m_hash ^ c) * 1099511628211ULL;
+        }
+    }
+
+    void add(size_t value)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            m_hash = (m_hash ^ ((value >> (i * 8)) & 0xff)) * 1099511628211ULL;
+        }
+    }
+
+    uint64_t hash() const { return m_hash; }
+
+private:
+    uint64_t m_hash = 14695981039346656037ULL;
+};
+
+static uint64_t hashOf(const ArtboardData& artboard)
+{
+    ContentHasher hasher;
+    hasher.add(artboard.artboardName);
+    hasher.add(artboard.artboardPascalCase);
+    hasher.add(artboard.artboardCameCase);
+    hasher.add(artboard.artboardSnakeCase);
+    hasher.add(artboard.artboardKebabCase);
+    hasher.add(artboard.animations.size());
+    for (const auto& animation : artboard.animations)
+    {
+        hasher.add(animation);
+    }
+    hasher.add(artboard.stateMachines.size());
+    for (const auto& stateMachine : artboard.stateMachines)
+    {
+        hasher.add(stateMachine.first);
+        hasher.add(stateMachine.second.size());
+        for (const auto& input : stateMachine.second)
+        {
+            hasher.add(input.name);
+            hasher.add(input.type);
+            hasher.add(input.defaultValue);
+        }
+    }
+    hasher.add(artboard.textValueRuns.size());
+    for (const auto& textValueRun : artboard.textValueRuns)
+    {
+        hasher.add(textValueRun.name);
+        hasher.add(textValueRun.defaultValue);
+    }
+    hasher.add(artboard.nestedTextValueRuns.size());
+    for (const auto& nestedTextValueRun : artboard.nestedTextValueRuns)
+    {
+        hasher.add(nestedTextValueRun.name);
+        hasher.add(nestedTextValueRun.path);
+    }
+    hasher.add(artboard.nestedArtboards.size());
+    for (const auto& nestedArtboard : artboard.nestedArtboards)
+    {
+        hasher.add(nestedArtboard.name);
+        hasher.add(nestedArtboard.artboardName);
+        hasher.add(nestedArtboard.artboardIndex);
+    }
+    return hasher.hash();
+}
+
+static uint64_t hashOf(const EnumInfo& enumInfo)
+{
+    ContentHasher hasher;
+    hasher.add(enumInfo.name);
+    hasher.add(enumInfo.values.size());
+    for (const auto& value : enumInfo.values)
+    {
+        hasher.add(value.key);
+    }
+    return hasher.hash();
+}
+
+static uint64_t hashOf(const ViewModelInfo& viewModel)
+{
+    ContentHasher hasher;
+    hasher.add(viewModel.name);
+    hasher.add(viewModel.properties.size());
+    for (const auto& property : viewModel.properties)
+    {
+        hasher.add(property.name);
+        hasher.add(property.type);
+        hasher.add(property.backingName);
+    }
+    return hasher.hash();
+}
+
+static bool equal(const ArtboardData& a, const ArtboardData& b)
+{
+    if (a.artboardName != b.artboardName ||
+        a.artboardPascalCase != b.artboardPascalCase ||
+        a.artboardCameCase != b.artboardCameCase ||
+        a.artboardSnakeCase != b.artboardSnakeCase ||
+        a.artboardKebabCase != b.artboardKebabCase ||
+        a.animations != b.animations ||
+        a.stateMachines.size() != b.stateMachines.size() ||
+        a.textValueRuns.size() != b.textValueRuns.size() ||
+        a.nestedTextValueRuns.size() != b.nestedTextValueRuns.size() ||
+        a.nestedArtboards.size() != b.nestedArtboards.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.stateMachines.size(); i++)
+    {
+        const auto& inputsA = a.stateMachines[i].second;
+        const auto& inputsB = b.stateMachines[i].second;
+        if (a.stateMachines[i].first != b.stateMachines[i].first ||
+            inputsA.size() != inputsB.size())
+        {
+            return false;
+        }
+        for (size_t j = 0; j < inputsA.size(); j++)
+        {
+            if (inputsA[j].name != inputsB[j].name ||
+                inputsA[j].type != inputsB[j].type ||
+                inputsA[j].defaultValue != inputsB[j].defaultValue)
+            {
+                return false;
+            }
+        }
+    }
+    for (size_t i = 0; i < a.textValueRuns.size(); i++)
+    {
+        if (a.textValueRuns[i].name != b.textValueRuns[i].name ||
+            a.textValueRuns[i].defaultValue != b.textValueRuns[i].defaultValue)
+        {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.nestedTextValueRuns.size(); i++)
+    {
+        if (a.nestedTextValueRuns[i].name != b.nestedTextValueRuns[i].name ||
+            a.nestedTextValueRuns[i].path != b.nestedTextValueRuns[i].path)
+        {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.nestedArtboards.size(); i++)
+    {
+        if (a.nestedArtboards[i].name != b.nestedArtboards[i].name ||
+            a.nestedArtboards[i].artboardName !=
+                b.nestedArtboards[i].artboardName ||
+            a.nestedArtboards[i].artboardIndex !=
+                b.nestedArtboards[i].artboardIndex)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool equal(const EnumInfo& a, const EnumInfo& b)
+{
+    if (a.name != b.name || a.values.size() != b.values.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.values.size(); i++)
+    {
+        if (a.values[i].key != b.values[i].key)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool equal(const ViewModelInfo& a, const ViewModelInfo& b)
+{
+    if (a.name != b.name || a.properties.size() != b.properties.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.properties.size(); i++)
+    {
+        if (a.properties[i].name != b.properties[i].name ||
+            a.properties[i].type != b.properties[i].type ||
+            a.properties[i].backingName != b.properties[i].backingName)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Hashes outside the lock, so that only the table lookup is serialized
+template <typename T, typename Table>
+static std::shared_ptr<const T> internIn(Table& table,
+                                         std::mutex& mutex,
+                                         T&& structure)
+{
+    uint64_t hash = hashOf(structure);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& candidates = table[hash];
+    for (const auto& candidate : candidates)
+    {
+        if (equal(*candidate, structure))
+        {
+            return candidate;
+        }
+    }
+    candidates.push_back(std::make_shared<const T>(std::move(structure)));
+    return candidates.back();
+}
+
+std::shared_ptr<const ArtboardData> StructureInterner::intern(
+    ArtboardData&& artboard)
+{
+    return internIn(m_artboards, m_mutex, std::move(artboard));
+}
+
+std::shared_ptr<const EnumInfo> StructureInterner::intern(EnumInfo&& enumInfo)
+{
+    return internIn(m_enums, m_mutex, std::move(enumInfo));
+}
+
+std::shared_ptr<const ViewModelInfo> StructureInterner::intern(
+    ViewModelInfo&& viewModel)
+{
+    return internIn(m_viewModels, m_mutex, std::move(viewModel));
+}
@@ -0,0 +1,595 @@
+#include "template_compiler.h"
+
+#include <unordered_map>
+
+using Data = kainjow::mustache::data;
+using Component = kainjow::mustache::component<std::string>;
+using TagType = kainjow::mustache::tag_type;
+
+// Values that make a section skip its contents
+static bool isFalsy(const Data& value)
+{
+    return value.is_false() || value.is_empty_list();
+}
+
+// Walks kainjow's parse tree, resolving names against the schema types of
+// the records each section pushes
+class TemplateCompiler
+{
+public:
+    using Instruction = CompiledTemplate::Instruction;
+    using Op = CompiledTemplate::Op;
+    using Slot = CompiledTemplate::Slot;
+
+    TemplateCompiler(CompiledTemplate& compiled,
+                     const TemplateSchema& schema,
+                     const std::vector<TemplateField>& rootFields) :
+        m_compiled(compiled), m_schema(schema)
+    {
+        addLayout(rootFields);
+        m_scopes.push_back(0);
+    }
+
+    bool compileChildren(const Component& component)
+    {
+        for (const auto& child : component.children)
+        {
+            if (!compileComponent(child))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Resolved
+    {
+        bool found = false;
+        uint32_t level = 0;
+        int layout = -1;
+        uint32_t slot = CompiledTemplate::NoSlot;
+    };
+
+    int addLayout(const std::vector<TemplateField>& fields)
+    {
+        m_compiled.m_layouts.emplace_back();
+        m_layoutFields.push_back(&fields);
+        m_slots.emplace_back();
+        return static_cast<int>(m_compiled.m_layouts.size() - 1);
+    }
+
+    // Records of the same type share a layout
+    int layoutFor(const std::string& type)
+    {
+        auto existing = m_typeLayouts.find(type);
+        if (existing != m_typeLayouts.end())
+        {
+            return existing->second;
+        }
+        int layout = addLayout(m_schema.at(type));
+        m_typeLayouts[type] = layout;
+        return layout;
+    }
+
+    bool compileComponent(const Component& component)
+    {
+        if (component.is_text())
+        {
+            if (component.is_newline())
+            {
+                emitText(Op::Newline, component.text);
+            }
+            else if (!m_compiled.m_instructions.empty() &&
+                     m_compiled.m_instructions.back().op == Op::Text)
+            {
+                m_compiled.m_text += component.text;
+                m_compiled.m_instructions.back().textSize +=
+                    static_cast<uint32_t>(component.text.size());
+            }
+            else
+            {
+                emitText(Op::Text, component.text);
+            }
+            return true;
+        }
+
+        const auto& tag = component.tag;
+        switch (tag.type)
+        {
+            case TagType::variable:
+            case TagType::unescaped_variable:
+            {
+                Resolved resolved = resolve(tag.name);
+                // Names nothing defines render nothing
+                if (resolved.found)
+                {
+                    Instruction instruction;
+                    instruction.op = tag.type == TagType::variable
+                                         ? Op::Variable
+                                         : Op::UnescapedVariable;
+                    instruction.level = resolved.level;
+                    instruction.layout = resolved.layout;
+                    instruction.slot = resolved.slot;
+                    m_compiled.m_instructions.push_back(instruction);
+                }
+                return true;
+            }
+            case TagType::section_begin:
+                return compileSection(component);
+            case TagType::section_begin_inverted:
+                return compileInvertedSection(component);
+            case TagType::partial:
+                return false;
+            default:
+                // Comments and set delimiter tags only matter to the parser
+                return true;
+        }
+    }
+
+    bool compileSection(const Component& component)
+    {
+        if (component.tag.name == ".")
+        {
+            return false;
+        }
+        Resolved resolved = resolve(component.tag.name);
+        if (!resolved.found)
+        {
+            // Sections over names nothing defines are skipped entirely
+            return true;
+        }
+
+        // Strings and true are pushed as is, and define no names
+        const Slot& slot =
+            m_compiled.m_layouts[resolved.layout].slots[resolved.slot];
+        int layout = slot.layout;
+
+        Instruction begin;
+        begin.op = Op::SectionBegin;
+        begin.level = resolved.level;
+        begin.layout = resolved.layout;
+        begin.slot = resolved.slot;
+        return compileSectionBody(component, begin, Op::SectionEnd, layout);
+    }
+
+    bool compileInvertedSection(const Component& component)
+    {
+        Resolved resolved = resolve(component.tag.name);
+        if (!resolved.found)
+        {
+            // Always rendered, without pushing anything
+            Instruction mark;
+            mark.op = Op::SectionTag;
+            m_compiled.m_instructions.push_back(mark);
+            if (!compileChildren(component))
+            {
+                return false;
+            }
+            m_compiled.m_instructions.push_back(mark);
+            return true;
+        }
+
+        Instruction begin;
+        begin.op = Op::InvertedBegin;
+        begin.level = resolved.level;
+        begin.layout = resolved.layout;
+        begin.slot = resolved.slot;
+        // Only false and empty lists are pushed, and nothing resolves in them
+        return compileSectionBody(component, begin, Op::InvertedEnd, -1);
+    }
+
+    bool compileSectionBody(const Component& component,
+                            Instruction begin,
+                            Op endOp,
+                            int layout)
+    {
+        auto depth = static_cast<uint32_t>(m_scopes.size());
+        auto beginIndex =
+            static_cast<uint32_t>(m_compiled.m_instructions.size());
+        begin.depth = depth;
+        m_compiled.m_instructions.push_back(begin);
+
+        m_scopes.push_back(layout);
+        if (m_scopes.size() > m_compiled.m_maxDepth)
+        {
+            m_compiled.m_maxDepth = static_cast<uint32_t>(m_scopes.size());
+        }
+        if (!compileChildren(component))
+        {
+            return false;
+        }
+        m_scopes.pop_back();
+
+        Instruction end;
+        end.op = endOp;
+        end.layout = layout;
+        end.depth = depth;
+        end.jump = beginIndex;
+        m_compiled.m_instructions[beginIndex].jump =
+            static_cast<uint32_t>(m_compiled.m_instructions.size());
+        m_compiled.m_instructions.push_back(end);
+        return true;
+    }
+
+    void emitText(Op op, const std::string& text)
+    {
+        Instruction instruction;
+        instruction.op = op;
+        instruction.textOffset =
+            static_cast<uint32_t>(m_compiled.m_text.size());
+        instruction.textSize = static_cast<uint32_t>(text.size());
+        m_compiled.m_text += text;
+        m_compiled.m_instructions.push_back(instruction);
+    }
+
+    // Finds the topmost level whose records define `name`, the way kainjow's
+    // context::get searches the context stack
+    Resolved resolve(const std::string& name)
+    {
+        Resolved resolved;
+        if (name == ".")
+        {
+            resolved.found = true;
+            resolved.level = static_cast<uint32_t>(m_scopes.size() - 1);
+            resolved.layout = m_scopes.back();
+            return resolved;
+        }
+
+        std::vector<std::string> path;
+        if (name.find('.') == std::string::npos)
+        {
+            path.push_back(name);
+        }
+        else
+        {
+            path = kainjow::mustache::split(name, '.');
+        }
+        for (size_t level = m_scopes.size(); level-- > 0;)
+        {
+            int layout = m_scopes[level];
+            if (layout >= 0 && slotFor(layout, name, path, resolved.slot))
+            {
+                resolved.found = true;
+                resolved.level = static_cast<uint32_t>(level);
+                resolved.layout = layout;
+                return resolved;
+            }
+        }
+        return resolved;
+    }
+
+    // The slot of `name` in the layout, if the layout's type has every part
+    // of its path
+    bool slotFor(int layoutIndex,
+                 const std::string& name,
+                 const std::vector<std::string>& path,
+                 uint32_t& slot)
+    {
+        auto& slots = m_slots[layoutIndex];
+        auto existing = slots.find(name);
+        if (existing != slots.end())
+        {
+            slot = existing->second;
+            return slot != CompiledTemplate::NoSlot;
+        }
+
+        const TemplateField* field = nullptr;
+        const std::vector<TemplateField>* fields = m_layoutFields[layoutIndex];
+        for (size_t i = 0; i < path.size(); i++)
+        {
+            field = nullptr;
+            if (fields != nullptr)
+            {
+                for (const auto& candidate : *fields)
+                {
+                    if (candidate.name == path[i])
+                    {
+                        field = &candidate;
+                        break;
+                    }
+                }
+            }
+            if (field == nullptr)
+            {
+                slots[name] = CompiledTemplate::NoSlot;
+                m_compiled.m_layouts[layoutIndex].absent.push_back(path);
+                return false;
+            }
+            // Only objects have names of their own
+            fields = field->kind == TemplateFieldKind::Object
+                         ? &m_schema.at(field->type)
+                         : nullptr;
+        }
+
+        Slot added;
+        added.path = path;
+        added.kind = field->kind;
+        if (field->kind == TemplateFieldKind::Object ||
+            field->kind == TemplateFieldKind::List)
+        {
+            added.layout = layoutFor(field->type);
+        }
+        // Looked up again, since adding the slot's layout may have moved it
+        auto& layout = m_compiled.m_layouts[layoutIndex];
+        slot = static_cast<uint32_t>(layout.slots.size());
+        layout.slots.push_back(std::move(added));
+        m_slots[layoutIndex][name] = slot;
+        return true;
+    }
+
+    CompiledTemplate& m_compiled;
+    const TemplateSchema& m_schema;
+    // Layout of each stack level, or -1 for levels holding a string, bool
+    // or list, which define no names
+    std::vector<int> m_scopes;
+    // The schema fields of each layout
+    std::vector<const std::vector<TemplateField>*> m_layoutFields;
+    std::unordered_map<std::string, int> m_typeLayouts;
+    // Slot of each name resolved against each layout, or NoSlot if absent
+    std::vector<std::unordered_map<std::string, uint32_t>> m_slots;
+};
+
+std::optional<CompiledTemplate> CompiledTemplate::compile(
+    const std::string& source,
+    const std::string& rootType)
+{
+    const TemplateSchema& schema = templateDataSchema();
+    auto root = schema.find(rootType);
+    if (root == schema.end())
+    {
+        return std::nullopt;
+    }
+
+    // Parse with kainjow itself so text and whitespace split up identically
+    kainjow::mustache::context<std::string> context;
+    kainjow::mustache::context_internal<std::string> parseContext{context};
+    Component tree;
+    std::string error;
+    kainjow::mustache::parser<std::string> parser{source,
+                                                  parseContext,
+                                                  tree,
+                                                  error};
+    if (!error.empty())
+    {
+        return std::nullopt;
+    }
+
+    CompiledTemplate compiled;
+    TemplateCompiler compiler(compiled, schema, root->second);
+    if (!compiler.compileChildren(tree))
+    {
+        return std::nullopt;
+    }
+    return compiled;
+}
+
+// kainjow drops lines that held a section tag and are otherwise blank
+static bool isBlank(const std::string& output, size_t lineStart)
+{
+    for (size_t i = lineStart; i < output.size(); i++)
+    {
+        if (output[i] != ' ' && output[i] != '\t')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Looks a name up in one record the way kainjow's context::get does
+static const Data* lookup(const Data& record,
+                          const std::vector<std::string>& path)
+{
+    const Data* value = &record;
+    for (const auto& part : path)
+    {
+        value = value->get(part);
+        if (value == nullptr)
+        {
+            return nullptr;
+        }
+    }
+    return value;
+}
+
+// Whether `value` holds what the schema says a field of `kind` does
+static bool hasKind(const Data& value, TemplateFieldKind kind)
+{
+    switch (kind)
+    {
+        case TemplateFieldKind::String:
+            return value.is_string();
+        case TemplateFieldKind::Bool:
+            return value.is_bool();
+        case TemplateFieldKind::Object:
+            return value.is_object();
+        case TemplateFieldKind::List:
+            return value.is_list();
+    }
+    return false;
+}
+
+bool CompiledTemplate::render(const kainjow::mustache::data& data,
+                              const EscapeFunction& escape,
+                              std::string& output) const
+{
+    // The item at each stack level, and the values of its slots if it's a
+    // record
+    struct Frame
+    {
+        const Data* value = nullptr;
+        std::vector<const Data*> slots;
+    };
+    // The list a section at each stack level is iterating over
+    struct Loop
+    {
+        const kainjow::mustache::list* items = nullptr;
+        uint32_t index = 0;
+    };
+    std::vector<Frame> stack(m_maxDepth);
+    std::vector<Loop> loops(m_maxDepth);
+
+    // Pushes `item` as a record of `layout`, looking up the names the
+    // template reads from it
+    const auto bind = [&](Frame& frame, const Data& item, int layout) -> bool
+    {
+        frame.value = &item;
+        if (layout < 0)
+        {
+            return true;
+        }
+        if (!item.is_object())
+        {
+            return false;
+        }
+        const auto& slots = m_layouts[layout].slots;
+        frame.slots.resize(slots.size());
+        for (size_t i = 0; i < slots.size(); i++)
+        {
+            const Data* value = lookup(item, slots[i].path);
+            if (value == nullptr || !hasKind(*value, slots[i].kind))
+            {
+                return false;
+            }
+            frame.slots[i] = value;
+        }
+        for (const auto& path : m_layouts[layout].absent)
+        {
+            if (lookup(item, path) != nullptr)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+    const auto valueOf = [&](const Instruction& instruction) -> const Data*
+    {
+        const Frame& frame = stack[instruction.level];
+        return instruction.slot == NoSlot ? frame.value
+                                          : frame.slots[instruction.slot];
+    };
+
+    if (!bind(stack[0], data, 0))
+    {
+        return false;
+    }
+    const size_t outputStart = output.size();
+    const auto fail = [&]()
+    {
+        output.resize(outputStart);
+        return false;
+    };
+
+    // Lines are rendered straight into the output and dropped again if they
+    // turn out to be blank lines holding section tags
+    size_t lineStart = output.size();
+    bool lineHasSection = false;
+    for (size_t pc = 0; pc < m_instructions.size(); pc++)
+    {
+        const auto& instruction = m_instructions[pc];
+        switch (instruction.op)
+        {
+            case Op::Text:
+                output.append(m_text,
+                              instruction.textOffset,
+                              instruction.textSize);
+                break;
+            case Op::Newline:
+                if (lineHasSection && isBlank(output, lineStart))
+                {
+                    output.resize(lineStart);
+                }
+                else
+                {
+                    output.append(m_text,
+                                  instruction.textOffset,
+                                  instruction.textSize);
+                }
+                lineStart = output.size();
+                lineHasSection = false;
+                break;
+            case Op::Variable:
+            case Op::UnescapedVariable:
+            {
+                const Data* value = valueOf(instruction);
+                if (!value->is_string())
+                {
+                    break;
+                }
+                if (instruction.op == Op::Variable)
+                {
+                    escape(output, value->string_value());
+                }
+                else
+                {
+                    output += value->string_value();
+                }
+                break;
+            }
+            case Op::SectionBegin:
+            {
+                const Data* value = valueOf(instruction);
+                if (isFalsy(*value))
+                {
+                    pc = instruction.jump;
+                    break;
+                }
+                lineHasSection = true;
+                const Layout& parent = m_layouts[instruction.layout];
+                int layout = parent.slots[instruction.slot].layout;
+                Loop& loop = loops[instruction.depth];
+                loop.items = nullptr;
+                if (value->is_list())
+                {
+                    loop.items = &value->list_value();
+                    loop.index = 0;
+                    value = &loop.items->front();
+                }
+                if (!bind(stack[instruction.depth], *value, layout))
+                {
+                    return fail();
+                }
+                break;
+            }
+            case Op::SectionEnd:
+            {
+                lineHasSection = true;
+                Loop& loop = loops[instruction.depth];
+                if (loop.items != nullptr && ++loop.index < loop.items->size())
+                {
+                    if (!bind(stack[instruction.depth],
+                              (*loop.items)[loop.index],
+                              instruction.layout))
+                    {
+                        return fail();
+                    }
+                    pc = instruction.jump;
+                }
+                break;
+            }
+            case Op::InvertedBegin:
+            {
+                const Data* value = valueOf(instruction);
+                if (!isFalsy(*value))
+                {
+                    pc = instruction.jump;
+                    break;
+                }
+                lineHasSection = true;
+                stack[instruction.depth].value = value;
+                break;
+            }
+            case Op::InvertedEnd:
+            case Op::SectionTag:
+                lineHasSection = true;
+                break;
+        }
+    }
+
+    if (lineHasSection && isBlank(output, lineStart))
+    {
+        output.resize(lineStart);
+    }
+    return true;
+}
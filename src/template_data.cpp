@@ -0,0 +1,458 @@
+#include "template_data.h"
+
+#include <utility>
+
+#include "extraction_stages.h"
+#include "naming.h"
+#include "string_escape.h"
+
+const std::string generatedFileName = "rive_generated";
+
+using Variants = CaseVariants TemplateCases::*;
+
+static const std::vector<std::pair<std::string, Variants>> variantsByKind = {
+    {"riv", &TemplateCases::riv},
+    {"asset", &TemplateCases::asset},
+    {"artboard", &TemplateCases::artboard},
+    {"animation", &TemplateCases::animation},
+    {"state_machine", &TemplateCases::stateMachine},
+    {"input", &TemplateCases::input},
+    {"text_value_run", &TemplateCases::textValueRun},
+    {"enum", &TemplateCases::enumName},
+    {"enum_value", &TemplateCases::enumValue},
+    {"view_model", &TemplateCases::viewModel},
+    {"property", &TemplateCases::property},
+    {"backing", &TemplateCases::backing},
+    {"nested_artboard", &TemplateCases::nestedArtboard},
+};
+
+TemplateCases casesForTemplate(const std::string& source)
+{
+    auto names = templateTagNames(source);
+    if (!names)
+    {
+        return TemplateCases();
+    }
+
+    TemplateCases cases;
+    for (const auto& entry : variantsByKind)
+    {
+        const auto uses = [&](const char* suffix)
+        { return names->count(entry.first + suffix) > 0; };
+        CaseVariants& variants = cases.*entry.second;
+        variants.camel = uses("_camel_case");
+        variants.pascal = uses("_pascal_case");
+        variants.snake = uses("_snake_case");
+        variants.kebab = uses("_kebab_case");
+    }
+    cases.nestedArtboardArtboardPascal =
+        names->count("nested_artboard_artboard_pascal_case") > 0;
+    cases.textValueRunDefaultSanitized =
+        names->count("text_value_run_default_sanitized") > 0;
+    return cases;
+}
+
+// The names of one kind of name's case variants
+struct CaseKeys
+{
+    std::string camel;
+    std::string pascal;
+    std::string snake;
+    std::string kebab;
+};
+
+static CaseKeys caseKeys(const std::string& kind)
+{
+    return {kind + "_camel_case",
+            kind + "_pascal_case",
+            kind + "_snake_case",
+            kind + "_kebab_case"};
+}
+
+static const CaseKeys assetKeys = caseKeys("asset");
+static const CaseKeys animationKeys = caseKeys("animation");
+static const CaseKeys stateMachineKeys = caseKeys("state_machine");
+static const CaseKeys inputKeys = caseKeys("input");
+static const CaseKeys textValueRunKeys = caseKeys("text_value_run");
+static const CaseKeys enumKeys = caseKeys("enum");
+static const CaseKeys enumValueKeys = caseKeys("enum_value");
+static const CaseKeys viewModelKeys = caseKeys("view_model");
+static const CaseKeys propertyKeys = caseKeys("property");
+static const CaseKeys backingKeys = caseKeys("backing");
+static const CaseKeys nestedArtboardKeys = caseKeys("nested_artboard");
+
+// Sets the case variants of `name` in `variants`, converting it only to those
+static void setCases(kainjow::mustache::data& data,
+                     const CaseKeys& keys,
+                     const std::string& name,
+                     const CaseVariants& variants)
+{
+    if (variants.camel)
+    {
+        data.set(keys.camel, toCamelCase(name));
+    }
+    if (variants.pascal)
+    {
+        data.set(keys.pascal, toPascalCase(name));
+    }
+    if (variants.snake)
+    {
+        data.set(keys.snake, toSnakeCase(name));
+    }
+    if (variants.kebab)
+    {
+        data.set(keys.kebab, toKebabCase(name));
+    }
+}
+
+// Template data for a single enum, without its position in the list
+static kainjow::mustache::data enumTemplateData(const EnumInfo& enumInfo,
+                                                const TemplateCases& cases)
+{
+    kainjow::mustache::data enumData;
+    enumData.set("enum_name", enumInfo.name);
+    setCases(enumData, enumKeys, enumInfo.name, cases.enumName);
+
+    std::vector<kainjow::mustache::data> enumValues;
+
+    enumValues.reserve(enumInfo.values.size());
+    for (size_t valueIndex = 0; valueIndex < enumInfo.values.size();
+         valueIndex++)
+    {
+        const auto& value = enumInfo.values[valueIndex];
+        kainjow::mustache::data valueData;
+        valueData.set("enum_value_key", value.key);
+        setCases(valueData, enumValueKeys, value.key, cases.enumValue);
+        valueData.set("last", (valueIndex == enumInfo.values.size() - 1));
+        enumValues.push_back(std::move(valueData));
+    }
+    enumData.set("enum_values", std::move(enumValues));
+    return enumData;
+}
+
+// Template data for a single view model, without its position in the list
+static kainjow::mustache::data viewModelTemplateData(
+    const ViewModelInfo& viewModel,
+    const TemplateCases& cases)
+{
+    kainjow::mustache::data viewmodelData;
+    viewmodelData.set("view_model_name", viewModel.name);
+    setCases(viewmodelData, viewModelKeys, viewModel.name, cases.viewModel);
+
+    std::vector<kainjow::mustache::data> properties;
+
+    properties.reserve(viewModel.properties.size());
+    for (size_t propIndex = 0; propIndex < viewModel.properties.size();
+         propIndex++)
+    {
+        const auto& property = viewModel.properties[propIndex];
+        kainjow::mustache::data propertyData;
+        propertyData.set("property_name", property.name);
+        setCases(propertyData, propertyKeys, property.name, cases.property);
+        propertyData.set("property_index", std::to_string(propIndex));
+
+        // Add property type information for the viewmodel template
+        kainjow::mustache::data propertyTypeData;
+        propertyTypeData.set("is_view_model", property.type == "viewModel");
+        propertyTypeData.set("is_enum", property.type == "enum");
+        propertyTypeData.set("is_string", property.type == "string");
+        propertyTypeData.set("is_number", property.type == "number");
+        propertyTypeData.set("is_integer", property.type == "integer");
+        propertyTypeData.set("is_boolean", property.type == "boolean");
+        propertyTypeData.set("is_color", property.type == "color");
+        propertyTypeData.set("is_list", property.type == "list");
+        propertyTypeData.set("is_trigger", property.type == "trigger");
+        propertyTypeData.set("backing_name", property.backingName);
+        setCases(propertyTypeData,
+                 backingKeys,
+                 property.backingName,
+                 cases.backing);
+        propertyData.set("property_type", std::move(propertyTypeData));
+
+        propertyData.set("last", propIndex == viewModel.properties.size() - 1);
+        properties.push_back(std::move(propertyData));
+    }
+    viewmodelData.set("properties", std::move(properties));
+    return viewmodelData;
+}
+
+// Template data for a single artboard, without its position in the list
+static kainjow::mustache::data artboardTemplateData(
+    const ArtboardData& artboard,
+    const TemplateCases& cases)
+{
+    kainjow::mustache::data artboardData;
+    artboardData.set("artboard_name", artboard.artboardName);
+    // Converted when extracted, since they're made unique across the file
+    if (cases.artboard.pascal)
+    {
+        artboardData.set("artboard_pascal_case", artboard.artboardPascalCase);
+    }
+    if (cases.artboard.camel)
+    {
+        artboardData.set("artboard_camel_case", artboard.artboardCameCase);
+    }
+    if (cases.artboard.snake)
+    {
+        artboardData.set("artboard_snake_case", artboard.artboardSnakeCase);
+    }
+    if (cases.artboard.kebab)
+    {
+        artboardData.set("artboard_kebab_case", artboard.artboardKebabCase);
+    }
+
+    std::unordered_set<std::string> usedAnimationNames;
+    std::vector<kainjow::mustache::data> animations;
+    animations.reserve(artboard.animations.size());
+    for (size_t animIndex = 0; animIndex < artboard.animations.size();
+         animIndex++)
+    {
+        const auto& animation = artboard.animations[animIndex];
+        kainjow::mustache::data animData;
+        auto uniqueName = makeUnique(animation, usedAnimationNames);
+        animData.set("animation_name", animation);
+        setCases(animData, animationKeys, uniqueName, cases.animation);
+        animData.set("animation_index", std::to_string(animIndex));
+        animData.set("last", (animIndex == artboard.animations.size() - 1));
+        animations.push_back(std::move(animData));
+    }
+    artboardData.set("animations", std::move(animations));
+
+    std::unordered_set<std::string> usedStateMachineNames;
+    std::vector<kainjow::mustache::data> stateMachines;
+    stateMachines.reserve(artboard.stateMachines.size());
+    for (size_t smIndex = 0; smIndex < artboard.stateMachines.size(); smIndex++)
+    {
+        const auto& stateMachine = artboard.stateMachines[smIndex];
+        kainjow::mustache::data stateMachineData;
+        auto uniqueName = makeUnique(stateMachine.first, usedStateMachineNames);
+        stateMachineData.set("state_machine_name", stateMachine.first);
+        setCases(stateMachineData,
+                 stateMachineKeys,
+                 uniqueName,
+                 cases.stateMachine);
+        stateMachineData.set("state_machine_index", std::to_string(smIndex));
+        stateMachineData.set("last",
+                             smIndex == artboard.stateMachines.size() - 1);
+
+        std::unordered_set<std::string> usedInputNames;
+        std::vector<kainjow::mustache::data> inputs;
+        inputs.reserve(stateMachine.second.size());
+        for (size_t inputIndex = 0; inputIndex < stateMachine.second.size();
+             inputIndex++)
+        {
+            const auto& input = stateMachine.second[inputIndex];
+            kainjow::mustache::data inputData;
+            auto uniqueName = makeUnique(input.name, usedInputNames);
+            inputData.set("input_name", input.name);
+            setCases(inputData, inputKeys, uniqueName, cases.input);
+            inputData.set("input_index", std::to_string(inputIndex));
+            inputData.set("input_type", input.type);
+            inputData.set("input_default_value", input.defaultValue);
+            inputData.set("last",
+                          inputIndex == stateMachine.second.size() - 1);
+            inputs.push_back(std::move(inputData));
+        }
+        stateMachineData.set("inputs", std::move(inputs));
+
+        stateMachines.push_back(std::move(stateMachineData));
+    }
+    artboardData.set("state_machines", std::move(stateMachines));
+
+    std::unordered_set<std::string> usedTextValueRunNames;
+    std::vector<kainjow::mustache::data> textValueRuns;
+    textValueRuns.reserve(artboard.textValueRuns.size());
+    for (size_t tvrIndex = 0; tvrIndex < artboard.textValueRuns.size();
+         tvrIndex++)
+    {
+        const auto& tvr = artboard.textValueRuns[tvrIndex];
+        kainjow::mustache::data tvrData;
+        auto uniqueName = makeUnique(tvr.name, usedTextValueRunNames);
+        tvrData.set("text_value_run_name", tvr.name);
+        setCases(tvrData, textValueRunKeys, uniqueName, cases.textValueRun);
+        tvrData.set("text_value_run_default", tvr.defaultValue);
+        if (cases.textValueRunDefaultSanitized)
+        {
+            tvrData.set("text_value_run_default_sanitized",
+                        sanitizeString(tvr.defaultValue));
+        }
+        tvrData.set("last", (tvrIndex == artboard.textValueRuns.size() - 1));
+        textValueRuns.push_back(std::move(tvrData));
+    }
+    artboardData.set("text_value_runs", std::move(textValueRuns));
+
+    std::vector<kainjow::mustache::data> nestedTextValueRuns;
+
+    nestedTextValueRuns.reserve(artboard.nestedTextValueRuns.size());
+    for (size_t ntvrIndex = 0; ntvrIndex < artboard.nestedTextValueRuns.size();
+         ntvrIndex++)
+    {
+        const auto& ntvr = artboard.nestedTextValueRuns[ntvrIndex];
+        kainjow::mustache::data ntvrData;
+        ntvrData.set("nested_text_value_run_name", ntvr.name);
+        ntvrData.set("nested_text_value_run_path", ntvr.path);
+        ntvrData.set("last",
+                     ntvrIndex == artboard.nestedTextValueRuns.size() - 1);
+        nestedTextValueRuns.push_back(std::move(ntvrData));
+    }
+
+    artboardData.set("nested_text_value_runs", std::move(nestedTextValueRuns));
+
+    // Edges to the artboards these are instances of, whose data is with
+    // theirs in the file's artboards
+    std::unordered_set<std::string> usedNestedArtboardNames;
+    std::vector<kainjow::mustache::data> nestedArtboards;
+    nestedArtboards.reserve(artboard.nestedArtboards.size());
+    for (size_t nestedIndex = 0; nestedIndex < artboard.nestedArtboards.size();
+         nestedIndex++)
+    {
+        const auto& nested = artboard.nestedArtboards[nestedIndex];
+        kainjow::mustache::data nestedData;
+        auto uniqueName = makeUnique(nested.name, usedNestedArtboardNames);
+        nestedData.set("nested_artboard_name", nested.name);
+        setCases(nestedData,
+                 nestedArtboardKeys,
+                 uniqueName,
+                 cases.nestedArtboard);
+        nestedData.set("nested_artboard_artboard_name", nested.artboardName);
+        if (cases.nestedArtboardArtboardPascal)
+        {
+            nestedData.set("nested_artboard_artboard_pascal_case",
+                           toPascalCase(nested.artboardName));
+        }
+        nestedData.set("nested_artboard_index",
+                       std::to_string(nested.artboardIndex));
+        nestedData.set("last",
+                       nestedIndex == artboard.nestedArtboards.size() - 1);
+        nestedArtboards.push_back(std::move(nestedData));
+    }
+    artboardData.set("nested_artboards", std::move(nestedArtboards));
+
+    return artboardData;
+}
+
+SharedStructures::SharedStructures(const TemplateCases& cases) :
+    cases(cases),
+    enums(enumTemplateData, cases),
+    viewModels(viewModelTemplateData, cases),
+    // The artboard's index in the file depends on the file, so unlike the
+    // rest of its data it's set for each use
+    artboards(artboardTemplateData, cases, "artboard_index")
+{}
+
+void SharedStructures::countFile(const RiveFileData& fileData)
+{
+    enums.countFile(fileData.enums);
+    viewModels.countFile(fileData.viewmodels);
+    artboards.countFile(fileData.artboards);
+}
+
+std::string fingerprintString(uint64_t fingerprint)
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; i--)
+    {
+        hex[i] = digits[(fingerprint >> ((15 - i) * 4)) & 0xf];
+    }
+    return hex;
+}
+
+// The file names exposed in {{#riv_files}}
+kainjow::mustache::data fileNameTemplateData(const RiveFileData& fileData,
+                                             bool last,
+                                             const TemplateCases& cases)
+{
+    kainjow::mustache::data riveFileData;
+    if (cases.riv.pascal)
+    {
+        riveFileData.set("riv_pascal_case", fileData.rivPascalCase);
+    }
+    if (cases.riv.camel)
+    {
+        riveFileData.set("riv_camel_case", fileData.rivCameCase);
+    }
+    if (cases.riv.snake)
+    {
+        riveFileData.set("riv_snake_case", fileData.riveSnakeCase);
+    }
+    if (cases.riv.kebab)
+    {
+        riveFileData.set("riv_kebab_case", fileData.rivKebabCase);
+    }
+    riveFileData.set("last", last);
+    return riveFileData;
+}
+
+kainjow::mustache::data fileTemplateData(const RiveFileData& fileData,
+                                         SharedStructures& shared,
+                                         bool last)
+{
+    const TemplateCases& cases = shared.cases;
+    kainjow::mustache::data riveFileData =
+        fileNameTemplateData(fileData, last, cases);
+    // Also at the top level, but having it here lets each file be rendered
+    // on its own
+    riveFileData.set("generated_file_name", generatedFileName);
+    riveFileData.set("riv_fingerprint",
+                     fingerprintString(fileData.fingerprint));
+    riveFileData.set("enums", shared.enums.list(fileData.enums));
+    riveFileData.set("view_models",
+                     shared.viewModels.list(fileData.viewmodels));
+
+    std::vector<kainjow::mustache::data> assets;
+
+    assets.reserve(fileData.assets.size());
+    for (size_t assetIndex = 0; assetIndex < fileData.assets.size();
+         assetIndex++)
+    {
+        const auto& asset = fileData.assets[assetIndex];
+        kainjow::mustache::data assetData;
+        assetData.set("asset_name", asset.name);
+        setCases(assetData, assetKeys, asset.name, cases.asset);
+        assetData.set("asset_type", asset.type);
+        assetData.set("asset_id", asset.assetId);
+        assetData.set("asset_cdn_uuid", asset.cdnUuid);
+        assetData.set("asset_cdn_base_url", asset.cdnBaseUrl);
+        assetData.set("last", (assetIndex == fileData.assets.size() - 1));
+        assets.push_back(std::move(assetData));
+    }
+    riveFileData.set("assets", std::move(assets));
+
+    riveFileData.set("artboards", shared.artboards.list(fileData.artboards));
+    return riveFileData;
+}
+
+// Converts the extracted data into the variables exposed to Mustache
+// templates
+kainjow::mustache::data buildTemplateData(
+    const std::vector<RiveFileData>& riveFileDataList,
+    const TemplateCases& cases)
+{
+    SharedStructures shared(cases);
+    for (const auto& fileData : riveFileDataList)
+    {
+        shared.countFile(fileData);
+    }
+
+    kainjow::mustache::data templateData;
+    std::vector<kainjow::mustache::data> riveFileList;
+    riveFileList.reserve(riveFileDataList.size());
+
+    for (size_t fileIndex = 0; fileIndex < riveFileDataList.size();
+         fileIndex++)
+    {
+        riveFileList.push_back(
+            fileTemplateData(riveFileDataList[fileIndex],
+                             shared,
+                             fileIndex == riveFileDataList.size() - 1));
+    }
+
+    templateData.set("generated_file_name", generatedFileName);
+    templateData.set("riv_files", std::move(riveFileList));
+    templateData.set("shared_enums", shared.enums.sharedList());
+    templateData.set("shared_view_models", shared.viewModels.sharedList());
+    templateData.set("shared_artboards", shared.artboards.sharedList());
+
+    return templateData;
+}
@@ -0,0 +1,329 @@
+#include "template_profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "string_escape.h"
+
+using Clock = std::chrono::steady_clock;
+using Component = kainjow::mustache::component_t;
+using Data = kainjow::mustache::data;
+using TagType = kainjow::mustache::tag_type;
+
+struct ProfileCounters
+{
+    // Times a section was reached, or tags on a line rendered
+    uint64_t renders = 0;
+    // Times a section's contents rendered
+    uint64_t iterations = 0;
+    uint64_t bytes = 0;
+    uint64_t lookups = 0;
+    // Context levels searched by the lookups
+    uint64_t depth = 0;
+    uint64_t misses = 0;
+    // Including what's nested for sections, excluding it for lines
+    Clock::duration time{0};
+};
+
+struct SectionProfile
+{
+    std::string tag;
+    size_t line = 0;
+    // Sections it's nested in
+    size_t nesting = 0;
+    ProfileCounters counters;
+};
+
+static bool isSection(const Component& comp)
+{
+    return comp.tag.type == TagType::section_begin ||
+           comp.tag.type == TagType::section_begin_inverted;
+}
+
+class TemplateProfiler : public kainjow::mustache::render_observer
+{
+public:
+    explicit TemplateProfiler(const std::string& source)
+    {
+        m_lineStarts.push_back(0);
+        for (size_t i = 0; i < source.size(); i++)
+        {
+            if (source[i] == '\n')
+            {
+                m_lineStarts.push_back(i + 1);
+            }
+        }
+    }
+
+    void enter(const Component& comp) override
+    {
+        m_frames.push_back({&comp, lineOf(comp), Clock::now(), {}, m_totals});
+        if (comp.is_text())
+        {
+            return;
+        }
+        m_lines[m_frames.back().line].renders++;
+        if (isSection(comp))
+        {
+            auto& section = m_sections[comp.position];
+            if (section.tag.empty())
+            {
+                section.tag = (comp.tag.type == TagType::section_begin
+                                   ? "{{#"
+                                   : "{{^") +
+                              comp.tag.name + "}}";
+                section.line = m_frames.back().line;
+                section.nesting = m_openSections;
+            }
+            section.counters.renders++;
+            m_openSections++;
+        }
+    }
+
+    void leave(const Component& comp) override
+    {
+        Frame frame = m_frames.back();
+        m_frames.pop_back();
+        auto elapsed = Clock::now() - frame.start;
+        m_lines[frame.line].time += elapsed - frame.nestedTime;
+        if (!m_frames.empty())
+        {
+            m_frames.back().nestedTime += elapsed;
+        }
+        if (isSection(comp))
+        {
+            m_openSections--;
+            auto& counters = m_sections[comp.position].counters;
+            counters.bytes += m_totals.bytes - frame.totalsBefore.bytes;
+            counters.lookups += m_totals.lookups - frame.totalsBefore.lookups;
+            counters.depth += m_totals.depth - frame.totalsBefore.depth;
+            counters.misses += m_totals.misses - frame.totalsBefore.misses;
+            counters.time += elapsed;
+        }
+    }
+
+    void section_iteration() override
+    {
+        m_sections[m_frames.back().comp->position].counters.iterations++;
+    }
+
+    void emitted(std::size_t size) override
+    {
+        m_totals.bytes += size;
+        if (!m_frames.empty())
+        {
+            m_lines[m_frames.back().line].bytes += size;
+        }
+    }
+
+    void lookedUp(size_t depth, bool found)
+    {
+        for (auto* counters : {&m_totals, currentLine()})
+        {
+            if (counters)
+            {
+                counters->lookups++;
+                counters->depth += depth;
+                counters->misses += found ? 0 : 1;
+            }
+        }
+    }
+
+    void finish(Clock::duration time) { m_totals.time = time; }
+
+    std::string report() const;
+
+private:
+    struct Frame
+    {
+        const Component* comp;
+        size_t line;
+        Clock::time_point start;
+        // Spent in the components rendered inside this one
+        Clock::duration nestedTime;
+        ProfileCounters totalsBefore;
+    };
+
+    // 1-based, like editors
+    size_t lineOf(const Component& comp) const
+    {
+        return std::upper_bound(m_lineStarts.begin(),
+                                m_lineStarts.end(),
+                                comp.position) -
+               m_lineStarts.begin();
+    }
+
+    ProfileCounters* currentLine()
+    {
+        return m_frames.empty() ? nullptr : &m_lines[m_frames.back().line];
+    }
+
+    std::vector<size_t> m_lineStarts;
+    std::vector<Frame> m_frames;
+    size_t m_openSections = 0;
+    ProfileCounters m_totals;
+    // By position in the template, so they're reported in its order
+    std::map<size_t, SectionProfile> m_sections;
+    std::map<size_t, ProfileCounters> m_lines;
+};
+
+// kainjow's context, counting the levels each lookup walks for the profiler
+class ProfilingContext : public kainjow::mustache::basic_context<std::string>
+{
+public:
+    ProfilingContext(const Data* data, TemplateProfiler& profiler) :
+        m_profiler(profiler)
+    {
+        push(data);
+    }
+
+    void push(const Data* data) override
+    {
+        m_items.insert(m_items.begin(), data);
+    }
+
+    void pop() override { m_items.erase(m_items.begin()); }
+
+    const Data* get(const std::string& name) const override
+    {
+        if (name == ".")
+        {
+            m_profiler.lookedUp(1, true);
+            return m_items.front();
+        }
+        const auto names = name.find('.') == std::string::npos
+                               ? std::vector<std::string>{name}
+                               : kainjow::mustache::split(name, '.');
+        size_t depth = 0;
+        for (const auto* item : m_items)
+        {
+            depth++;
+            const Data* var = item;
+            for (const auto& part : names)
+            {
+                var = var->get(part);
+                if (!var)
+                {
+                    break;
+                }
+            }
+            if (var)
+            {
+                m_profiler.lookedUp(depth, true);
+                return var;
+            }
+        }
+        m_profiler.lookedUp(depth, false);
+        return nullptr;
+    }
+
+    const Data* get_partial(const std::string& name) const override
+    {
+        for (const auto* item : m_items)
+        {
+            if (const auto* var = item->get(name))
+            {
+                return var;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    TemplateProfiler& m_profiler;
+    std::vector<const Data*> m_items;
+};
+
+static void writeCounters(std::ostream& out,
+                          const ProfileCounters& counters,
+                          bool isSection)
+{
+    out << std::setw(9) << counters.renders;
+    if (isSection)
+    {
+        out << std::setw(11) << counters.iterations;
+    }
+    out << std::setw(11) << counters.bytes << std::setw(9) << counters.lookups
+        << std::setw(9) << counters.depth << std::setw(8) << counters.misses
+        << std::setw(11) << std::fixed << std::setprecision(3)
+        << std::chrono::duration<double, std::milli>(counters.time).count()
+        << "\n";
+}
+
+std::string TemplateProfiler::report() const
+{
+    std::ostringstream out;
+    out << "Template profile\n\nSections, including what they contain:\n";
+    out << std::left << std::setw(6) << "line" << std::setw(30) << "section"
+        << std::right << std::setw(9) << "renders" << std::setw(11)
+        << "iterations" << std::setw(11) << "bytes" << std::setw(9)
+        << "lookups" << std::setw(9) << "depth" << std::setw(8) << "misses"
+        << std::setw(11) << "ms"
+        << "\n";
+    for (const auto& entry : m_sections)
+    {
+        const auto& section = entry.second;
+        std::string tag = std::string(section.nesting * 2, ' ') + section.tag;
+        out << std::left << std::setw(6) << section.line << std::setw(30)
+            << tag << std::right;
+        // Long names push the counters along rather than being cut
+        if (tag.size() >= 30)
+        {
+            out << " ";
+        }
+        writeCounters(out, section.counters, true);
+    }
+
+    out << "\nLines, excluding the sections they start:\n";
+    out << std::left << std::setw(6) << "line" << std::right << std::setw(9)
+        << "tags" << std::setw(11) << "bytes" << std::setw(9) << "lookups"
+        << std::setw(9) << "depth" << std::setw(8) << "misses"
+        << std::setw(11) << "ms"
+        << "\n";
+    for (const auto& entry : m_lines)
+    {
+        // Such as the ends of sections, which take time but do nothing
+        if (entry.second.renders == 0 && entry.second.bytes == 0)
+        {
+            continue;
+        }
+        out << std::left << std::setw(6) << entry.first << std::right;
+        writeCounters(out, entry.second, false);
+    }
+
+    out << "\nTotal: " << m_totals.bytes << " bytes, " << m_totals.lookups
+        << " lookups walking " << m_totals.depth << " levels, "
+        << m_totals.misses << " misses\nTime: " << std::fixed
+        << std::setprecision(3)
+        << std::chrono::duration<double, std::milli>(m_totals.time).count()
+        << " ms\n";
+    return out.str();
+}
+
+std::string renderTemplateProfiled(const std::string& templateStr,
+                                   const kainjow::mustache::data& templateData,
+                                   std::string& report)
+{
+    kainjow::mustache::mustache tmpl(templateStr);
+    if (!tmpl.is_valid())
+    {
+        // Renders nothing, as it does unprofiled
+        report = "Template doesn't parse: " + tmpl.error_message() + "\n";
+        return std::string();
+    }
+    tmpl.set_custom_escape(htmlEscape);
+
+    TemplateProfiler profiler(templateStr);
+    tmpl.set_render_observer(&profiler);
+    ProfilingContext context(&templateData, profiler);
+    auto start = Clock::now();
+    std::string result = tmpl.render(context);
+    profiler.finish(Clock::now() - start);
+
+    report = profiler.report();
+    return result;
+}
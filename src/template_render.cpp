@@ -0,0 +1,91 @@
+#include "template_render.h"
+
+#include <utility>
+
+#include "parallel_for.h"
+#include "string_escape.h"
+#include "template_compiler.h"
+#include "template_data.h"
+
+TemplateRenderer::TemplateRenderer(std::string source,
+                                   const std::string& rootType) :
+    m_source(std::move(source)),
+    m_compiled(CompiledTemplate::compile(m_source, rootType))
+{}
+
+std::string TemplateRenderer::render(
+    const kainjow::mustache::data& data) const
+{
+    std::string result;
+    if (m_compiled && m_compiled->render(data, appendHtmlEscaped, result))
+    {
+        return result;
+    }
+    // Fall back to kainjow for what the compiler doesn't handle
+    kainjow::mustache::mustache tmpl(m_source);
+    tmpl.set_custom_escape(htmlEscape);
+    return tmpl.render(data);
+}
+
+SplitRenderers::SplitRenderers(const TemplateSplit& split) :
+    header(split.header), item(split.item, "File"), footer(split.footer),
+    empty(split.empty)
+{}
+
+// Renders each file's item of `split` on a thread per core, which gives the
+// same output as rendering the whole template
+std::string renderFilesInParallel(
+    const SplitRenderers& split,
+    const std::vector<RiveFileData>& riveFileDataList,
+    const TemplateCases& cases)
+{
+    kainjow::mustache::data templateData =
+        buildTemplateData(riveFileDataList, cases);
+    const auto& files = templateData.get("riv_files")->list_value();
+
+    std::vector<std::string> items(files.size());
+    parallelFor(files.size(),
+                [&](size_t i) { items[i] = split.item.render(files[i]); });
+
+    std::string result = split.header.render(templateData);
+    if (files.empty())
+    {
+        result += split.empty;
+    }
+    for (const auto& item : items)
+    {
+        result += item;
+    }
+    result += split.footer.render(templateData);
+    return result;
+}
+
+ParsedTemplate::ParsedTemplate(std::string source) :
+    m_stages(stagesForTemplate(source)),
+    m_cases(casesForTemplate(source)),
+    m_renderer(std::move(source))
+{
+    kainjow::mustache::mustache tmpl(m_renderer.source());
+    if (!tmpl.is_valid())
+    {
+        m_error = tmpl.error_message();
+        return;
+    }
+    std::string splitError;
+    auto split = splitTemplate(m_renderer.source(),
+                               SplitMode::Parallel,
+                               splitError);
+    if (split)
+    {
+        m_parallelSplit.emplace(*split);
+    }
+}
+
+std::string ParsedTemplate::render(const std::vector<RiveFileData>& files) const
+{
+    if (m_parallelSplit && files.size() > 1)
+    {
+        return renderFilesInParallel(*m_parallelSplit, files, m_cases);
+    }
+    return m_renderer.render(buildTemplateData(files, m_cases));
+}
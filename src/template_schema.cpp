@@ -0,0 +1,173 @@
+#include "template_schema.h"
+
+static void addCaseFields(std::vector<TemplateField>& fields,
+                          const std::string& kind)
+{
+    for (const char* suffix :
+         {"_camel_case", "_pascal_case", "_snake_case", "_kebab_case"})
+    {
+        fields.push_back({kind + suffix, TemplateFieldKind::String, ""});
+    }
+}
+
+// Mirrors buildTemplateData and the functions it calls in template_data.cpp
+static TemplateSchema buildSchema()
+{
+    const auto String = TemplateFieldKind::String;
+    const auto Bool = TemplateFieldKind::Bool;
+    const auto Object = TemplateFieldKind::Object;
+    const auto List = TemplateFieldKind::List;
+
+    TemplateSchema schema;
+
+    schema["Root"] = {
+        {"generated_file_name", String, ""},
+        {"riv_files", List, "File"},
+        {"shared_enums", List, "Enum"},
+        {"shared_view_models", List, "ViewModel"},
+        {"shared_artboards", List, "Artboard"},
+    };
+
+    auto& file = schema["File"];
+    addCaseFields(file, "riv");
+    file.insert(file.end(),
+                {
+                    {"last", Bool, ""},
+                    {"generated_file_name", String, ""},
+                    {"riv_fingerprint", String, ""},
+                    {"enums", List, "Enum"},
+                    {"view_models", List, "ViewModel"},
+                    {"assets", List, "Asset"},
+                    {"artboards", List, "Artboard"},
+                });
+
+    auto& enumType = schema["Enum"];
+    enumType.push_back({"enum_name", String, ""});
+    addCaseFields(enumType, "enum");
+    enumType.push_back({"enum_values", List, "EnumValue"});
+    enumType.push_back({"is_shared", Bool, ""});
+    enumType.push_back({"last", Bool, ""});
+
+    auto& enumValue = schema["EnumValue"];
+    enumValue.push_back({"enum_value_key", String, ""});
+    addCaseFields(enumValue, "enum_value");
+    enumValue.push_back({"last", Bool, ""});
+
+    auto& viewModel = schema["ViewModel"];
+    viewModel.push_back({"view_model_name", String, ""});
+    addCaseFields(viewModel, "view_model");
+    viewModel.push_back({"properties", List, "Property"});
+    viewModel.push_back({"is_shared", Bool, ""});
+    viewModel.push_back({"last", Bool, ""});
+
+    auto& property = schema["Property"];
+    property.push_back({"property_name", String, ""});
+    addCaseFields(property, "property");
+    property.push_back({"property_index", String, ""});
+    property.push_back({"property_type", Object, "PropertyType"});
+    property.push_back({"last", Bool, ""});
+
+    auto& propertyType = schema["PropertyType"];
+    for (const char* type : {"view_model",
+                             "enum",
+                             "string",
+                             "number",
+                             "integer",
+                             "boolean",
+                             "color",
+                             "list",
+                             "trigger"})
+    {
+        propertyType.push_back({std::string("is_") + type, Bool, ""});
+    }
+    propertyType.push_back({"backing_name", String, ""});
+    addCaseFields(propertyType, "backing");
+
+    auto& asset = schema["Asset"];
+    asset.push_back({"asset_name", String, ""});
+    addCaseFields(asset, "asset");
+    asset.insert(asset.end(),
+                 {
+                     {"asset_type", String, ""},
+                     {"asset_id", String, ""},
+                     {"asset_cdn_uuid", String, ""},
+                     {"asset_cdn_base_url", String, ""},
+                     {"last", Bool, ""},
+                 });
+
+    auto& artboard = schema["Artboard"];
+    artboard.push_back({"artboard_name", String, ""});
+    addCaseFields(artboard, "artboard");
+    artboard.insert(
+        artboard.end(),
+        {
+            {"artboard_index", String, ""},
+            {"animations", List, "Animation"},
+            {"state_machines", List, "StateMachine"},
+            {"text_value_runs", List, "TextValueRun"},
+            {"nested_text_value_runs", List, "NestedTextValueRun"},
+            {"nested_artboards", List, "NestedArtboard"},
+            {"is_shared", Bool, ""},
+            {"last", Bool, ""},
+        });
+
+    auto& animation = schema["Animation"];
+    animation.push_back({"animation_name", String, ""});
+    addCaseFields(animation, "animation");
+    animation.push_back({"animation_index", String, ""});
+    animation.push_back({"last", Bool, ""});
+
+    auto& stateMachine = schema["StateMachine"];
+    stateMachine.push_back({"state_machine_name", String, ""});
+    addCaseFields(stateMachine, "state_machine");
+    stateMachine.push_back({"state_machine_index", String, ""});
+    stateMachine.push_back({"inputs", List, "Input"});
+    stateMachine.push_back({"last", Bool, ""});
+
+    auto& input = schema["Input"];
+    input.push_back({"input_name", String, ""});
+    addCaseFields(input, "input");
+    input.insert(input.end(),
+                 {
+                     {"input_index", String, ""},
+                     {"input_type", String, ""},
+                     {"input_default_value", String, ""},
+                     {"last", Bool, ""},
+                 });
+
+    auto& textValueRun = schema["TextValueRun"];
+    textValueRun.push_back({"text_value_run_name", String, ""});
+    addCaseFields(textValueRun, "text_value_run");
+    textValueRun.insert(textValueRun.end(),
+                        {
+                            {"text_value_run_default", String, ""},
+                            {"text_value_run_default_sanitized", String, ""},
+                            {"last", Bool, ""},
+                        });
+
+    schema["NestedTextValueRun"] = {
+        {"nested_text_value_run_name", String, ""},
+        {"nested_text_value_run_path", String, ""},
+        {"last", Bool, ""},
+    };
+
+    auto& nestedArtboard = schema["NestedArtboard"];
+    nestedArtboard.push_back({"nested_artboard_name", String, ""});
+    addCaseFields(nestedArtboard, "nested_artboard");
+    nestedArtboard.insert(
+        nestedArtboard.end(),
+        {
+            {"nested_artboard_artboard_name", String, ""},
+            {"nested_artboard_artboard_pascal_case", String, ""},
+            {"nested_artboard_index", String, ""},
+            {"last", Bool, ""},
+        });
+
+    return schema;
+}
+
+const TemplateSchema& templateDataSchema()
+{
+    static const TemplateSchema schema = buildSchema();
+    return schema;
+}
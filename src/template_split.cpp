@@ -0,0 +1,204 @@
+#include "template_split.h"
+
+#include <unordered_set>
+
+#include "kainjow/mustache.hpp"
+
+using Component = kainjow::mustache::component<std::string>;
+using TagType = kainjow::mustache::tag_type;
+
+static const std::string fileSection = "riv_files";
+
+// What the header and footer can use
+static const std::unordered_set<std::string> indexNames = {
+    ".",
+    "generated_file_name",
+    "riv_files",
+    "riv_pascal_case",
+    "riv_camel_case",
+    "riv_snake_case",
+    "riv_kebab_case",
+    "last",
+};
+
+static bool isInlineSpace(char c) { return c == ' ' || c == '\t'; }
+
+// Start of the line `position` is on, if only spaces and tabs precede it
+static std::optional<size_t> lineStartBefore(const std::string& source,
+                                             size_t position)
+{
+    while (position > 0 && isInlineSpace(source[position - 1]))
+    {
+        position--;
+    }
+    if (position > 0 && source[position - 1] != '\n')
+    {
+        return std::nullopt;
+    }
+    return position;
+}
+
+// Start of the next line after `position`, if only spaces and tabs follow it
+static std::optional<size_t> lineEndAfter(const std::string& source,
+                                          size_t position)
+{
+    while (position < source.size() && isInlineSpace(source[position]))
+    {
+        position++;
+    }
+    if (source.compare(position, 2, "\r\n") == 0)
+    {
+        return position + 2;
+    }
+    if (position < source.size() && source[position] != '\n')
+    {
+        return std::nullopt;
+    }
+    return position < source.size() ? position + 1 : position;
+}
+
+// Whether every tag in `component` passes `allowed`
+template <typename Allowed>
+static bool tagsAllowed(const Component& component, const Allowed& allowed)
+{
+    switch (component.tag.type)
+    {
+        case TagType::text:
+        case TagType::comment:
+            break;
+        case TagType::partial:
+        case TagType::set_delimiter:
+            // Could pull in anything, or change how the rest parses
+            return false;
+        default:
+            if (!allowed(component.tag.name))
+            {
+                return false;
+            }
+            break;
+    }
+    for (const auto& child : component.children)
+    {
+        if (!tagsAllowed(child, allowed))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool isIndexName(const std::string& name)
+{
+    return indexNames.count(name) != 0;
+}
+
+// Whether an item can use `name`, judged by the part a dotted name is
+// looked up by
+static bool isParallelItemName(const std::string& name)
+{
+    std::string first = name.substr(0, name.find('.'));
+    return first != fileSection && first.compare(0, 7, "shared_") != 0;
+}
+
+static bool isStreamedItemName(const std::string& name)
+{
+    return isParallelItemName(name) && name != "is_shared";
+}
+
+static bool isAnyName(const std::string&) { return true; }
+
+std::optional<TemplateSplit> splitTemplate(const std::string& source,
+                                           SplitMode mode,
+                                           std::string& error)
+{
+    kainjow::mustache::context<std::string> context;
+    kainjow::mustache::context_internal<std::string> parseContext{context};
+    Component root;
+    kainjow::mustache::parser<std::string> parser{source,
+                                                  parseContext,
+                                                  root,
+                                                  error};
+    if (!error.empty())
+    {
+        return std::nullopt;
+    }
+
+    const auto& children = root.children;
+    size_t sectionIndex = children.size();
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        if (children[i].tag.type == TagType::section_begin &&
+            children[i].tag.name == fileSection)
+        {
+            sectionIndex = i;
+        }
+    }
+    if (sectionIndex == children.size())
+    {
+        error = "no top-level {{#riv_files}} section";
+        return std::nullopt;
+    }
+
+    const Component& section = children[sectionIndex];
+    bool streaming = mode == SplitMode::Streaming;
+    bool (*headerName)(const std::string&) =
+        streaming ? isIndexName : isAnyName;
+    bool (*itemName)(const std::string&) =
+        streaming ? isStreamedItemName : isParallelItemName;
+    bool allowed = true;
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        if (i != sectionIndex)
+        {
+            allowed = allowed && tagsAllowed(children[i], headerName);
+        }
+    }
+    for (const auto& child : section.children)
+    {
+        allowed = allowed && tagsAllowed(child, itemName);
+    }
+    if (!allowed)
+    {
+        error = "uses data that needs every file at once, a partial or a "
+                "set delimiter";
+        return std::nullopt;
+    }
+
+    // The parser only records where the section's contents start and how
+    // long they are, so the closing tag is found from the contents and the
+    // next component
+    std::optional<size_t> headerEnd = lineStartBefore(source,
+                                                      section.position);
+    std::optional<size_t> itemStart;
+    std::optional<size_t> itemEnd;
+    std::optional<size_t> footerStart;
+    size_t closeEnd = sectionIndex + 1 < children.size()
+                          ? children[sectionIndex + 1].position
+                          : source.size();
+    if (!section.children.empty())
+    {
+        size_t contentStart = section.children.front().position;
+        itemStart = lineEndAfter(source, contentStart);
+        itemEnd = lineStartBefore(source,
+                                  contentStart +
+                                      section.tag.section_text->size());
+        footerStart = lineEndAfter(source, closeEnd);
+    }
+    if (!headerEnd || !itemStart || !itemEnd || !footerStart ||
+        *itemStart > *itemEnd)
+    {
+        error = "the {{#riv_files}} and {{/riv_files}} tags must be on lines "
+                "of their own";
+        return std::nullopt;
+    }
+
+    TemplateSplit split;
+    split.header = source.substr(0, *headerEnd);
+    split.item = source.substr(*itemStart, *itemEnd - *itemStart);
+    split.footer = source.substr(*footerStart);
+    // kainjow keeps the line of a skipped section, minus the tags
+    split.empty =
+        source.substr(*headerEnd, section.position - *headerEnd) +
+        source.substr(closeEnd, *footerStart - closeEnd);
+    return split;
+}
@@ -0,0 +1,126 @@
+// Counts the heap allocations made handing a Rive file's data from
+// extraction to the template, to check that none of it is copied wholesale
+// on the way. Usage: allocation_test <file.riv>
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "bounded_queue.h"
+#include "extraction_stages.h"
+#include "kainjow/mustache.hpp"
+#include "rive_extractor.h"
+#include "rive_file_data.h"
+#include "structure_interner.h"
+#include "template_data.h"
+
+static std::atomic<size_t> gAllocations{0};
+
+void* operator new(size_t size)
+{
+    gAllocations++;
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
+// Allocations made by `work`
+template <typename Work>
+static size_t countAllocations(const Work& work)
+{
+    size_t before = gAllocations;
+    work();
+    return gAllocations - before;
+}
+
+// Allocations made handing `file` from extraction to rendering through the
+// queue --stream uses, ending up in `files`
+static size_t handOffAllocations(RiveFileData file,
+                                 std::vector<RiveFileData>& files)
+{
+    return countAllocations(
+        [&]()
+        {
+            BoundedQueue<RiveFileData> queue(1);
+            queue.push(std::move(file));
+            queue.close();
+            while (auto popped = queue.pop())
+            {
+                files.push_back(std::move(*popped));
+            }
+        });
+}
+
+// Building the template data can allocate this many times what one copy of
+// the result does, for the case conversions and name deduplication
+static constexpr size_t templateDataBudget = 2;
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "Usage: allocation_test <file.riv>" << std::endl;
+        return 1;
+    }
+
+    StructureInterner interner;
+    auto extracted =
+        processRiveFile(argv[1], interner, ExtractionStages::all());
+    if (!extracted || extracted->artboards.empty())
+    {
+        std::cerr << "Error: " << argv[1] << " has no artboards" << std::endl;
+        return 1;
+    }
+
+    // The queue's own allocations are the same for any file, so handing off
+    // the extracted file makes more than an empty one only if it's copied
+    std::vector<RiveFileData> empty;
+    empty.reserve(1);
+    size_t emptyHandOff = handOffAllocations(RiveFileData(), empty);
+    std::vector<RiveFileData> files;
+    files.reserve(1);
+    size_t handOff = handOffAllocations(std::move(*extracted), files);
+    std::cout << "Handing off the extracted file: ";
+    if (handOff == emptyHandOff)
+    {
+        std::cout << "not copied";
+    }
+    else
+    {
+        std::cout << handOff << " allocations, an empty file makes "
+                  << emptyHandOff;
+    }
+    std::cout << std::endl;
+
+    ArtboardData repeated = *files[0].artboards[0];
+    std::cout << "Interning a repeated artboard: "
+              << countAllocations([&]()
+                                  { interner.intern(std::move(repeated)); })
+              << " allocations" << std::endl;
+
+    kainjow::mustache::data templateData;
+    size_t built = countAllocations(
+        [&]() { templateData = buildTemplateData(files); });
+    size_t copied = countAllocations(
+        [&]() { kainjow::mustache::data copy = templateData; });
+    std::cout << "Building the template data: ";
+    if (built <= copied * templateDataBudget)
+    {
+        std::cout << "within " << templateDataBudget << "x of one copy";
+    }
+    else
+    {
+        std::cout << built << " allocations, one copy makes " << copied;
+    }
+    std::cout << std::endl;
+    return 0;
+}
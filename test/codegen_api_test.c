@@ -0,0 +1,101 @@
+// Renders a template for Rive files read into memory, through the C API of
+// the rive_codegen library, the way an embedding host would. Written in C
+// to check that the header compiles as C.
+// Usage: codegen_api_test <template> <file.riv>...
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rive_codegen.h"
+
+static char* readFile(const char* path, size_t* size)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f)
+    {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* bytes = malloc(length > 0 ? length : 1);
+    *size = fread(bytes, 1, length, f);
+    fclose(f);
+    return bytes;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: codegen_api_test <template> <file.riv>...\n");
+        return 1;
+    }
+    if (rive_codegen_api_version() != RIVE_CODEGEN_API_VERSION)
+    {
+        fprintf(stderr, "Error: API version mismatch\n");
+        return 1;
+    }
+
+    size_t sourceSize = 0;
+    char* source = readFile(argv[1], &sourceSize);
+    rive_codegen_template* tmpl = NULL;
+    if (!source ||
+        rive_codegen_template_parse(source, sourceSize, &tmpl) !=
+            RIVE_CODEGEN_OK)
+    {
+        fprintf(stderr, "Error: %s\n", rive_codegen_last_error());
+        return 1;
+    }
+    free(source);
+
+    size_t fileCount = (size_t)(argc - 2);
+    rive_codegen_context* context = rive_codegen_context_create();
+    rive_codegen_file** files = calloc(fileCount, sizeof(*files));
+    for (size_t i = 0; i < fileCount; i++)
+    {
+        size_t size = 0;
+        char* bytes = readFile(argv[i + 2], &size);
+        if (!bytes ||
+            rive_codegen_file_open(context,
+                                   argv[i + 2],
+                                   strlen(argv[i + 2]),
+                                   (const uint8_t*)bytes,
+                                   size,
+                                   rive_codegen_template_stages(tmpl),
+                                   &files[i]) != RIVE_CODEGEN_OK)
+        {
+            fprintf(stderr, "Error: %s\n", rive_codegen_last_error());
+            return 1;
+        }
+        free(bytes);
+    }
+
+    // An empty buffer reports the size the output needs
+    size_t size = 0;
+    if (rive_codegen_render(tmpl, files, fileCount, NULL, 0, &size) !=
+        RIVE_CODEGEN_BUFFER_TOO_SMALL)
+    {
+        fprintf(stderr, "Error: an empty buffer was big enough\n");
+        return 1;
+    }
+    char* output = malloc(size > 0 ? size : 1);
+    if (rive_codegen_render(tmpl, files, fileCount, output, size, &size) !=
+        RIVE_CODEGEN_OK)
+    {
+        fprintf(stderr, "Error: %s\n", rive_codegen_last_error());
+        return 1;
+    }
+    fwrite(output, 1, size, stdout);
+
+    free(output);
+    for (size_t i = 0; i < fileCount; i++)
+    {
+        rive_codegen_file_close(files[i]);
+    }
+    free(files);
+    rive_codegen_context_destroy(context);
+    rive_codegen_template_destroy(tmpl);
+    return 0;
+}
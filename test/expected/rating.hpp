@@ -0,0 +1,198 @@
+// rive_generated.hpp
+
+// Generated by the Rive Code Generator, do not edit.
+//
+// Every artboard, animation, state machine and input is a struct holding its
+// name and its index in the Rive file, so runtimes can bind by index. Each
+// list also provides indexOf(name), a compile-time perfect-hash lookup that
+// costs one hash and one string comparison, returning -1 for unknown names.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace rive_generated
+{
+enum class InputType
+{
+    number,
+    boolean,
+    trigger,
+    unknown,
+};
+
+namespace detail
+{
+constexpr uint32_t hashName(std::string_view name, uint32_t seed)
+{
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : name)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+template <uint32_t Size, std::size_t Count>
+constexpr int32_t lookup(const std::string_view (&names)[Count],
+                         const uint32_t (&seeds)[Size],
+                         const int32_t (&slots)[Size],
+                         std::string_view name)
+{
+    uint32_t seed = seeds[hashName(name, 0) & (Size - 1)];
+    int32_t index = slots[hashName(name, seed) & (Size - 1)];
+    return index >= 0 && names[index] == name ? index : -1;
+}
+} // namespace detail
+
+struct Rating
+{
+    static constexpr std::string_view name = "rating";
+
+    struct artboards
+    {
+        static constexpr uint32_t count = 1;
+        static constexpr std::string_view names[1] = {
+            "Complete",
+        };
+        static constexpr uint32_t seeds[1] = {
+            1,
+        };
+        static constexpr int32_t slots[1] = {
+            0,
+        };
+        static constexpr int32_t indexOf(std::string_view name)
+        {
+            return detail::lookup<1>(names, seeds, slots, name);
+        }
+
+        struct Complete
+        {
+            static constexpr std::string_view name = "Complete";
+            static constexpr uint32_t index = 0;
+
+            struct animations
+            {
+                static constexpr uint32_t count = 7;
+                static constexpr std::string_view names[7] = {
+                    "Thumbnail",
+                    "5_stars",
+                    "4_stars",
+                    "3_stars",
+                    "2_stars",
+                    "1_star",
+                    "Idle_empty",
+                };
+                static constexpr uint32_t seeds[8] = {
+                    1, 0, 1, 3, 0, 3, 2, 0,
+                };
+                static constexpr int32_t slots[8] = {
+                    1, 5, 2, 3, 4, 6, -1, 0,
+                };
+                static constexpr int32_t indexOf(std::string_view name)
+                {
+                    return detail::lookup<8>(names, seeds, slots, name);
+                }
+
+                struct Thumbnail
+                {
+                    static constexpr std::string_view name = "Thumbnail";
+                    static constexpr uint32_t index = 0;
+                };
+
+                struct n5Stars
+                {
+                    static constexpr std::string_view name = "5_stars";
+                    static constexpr uint32_t index = 1;
+                };
+
+                struct n4Stars
+                {
+                    static constexpr std::string_view name = "4_stars";
+                    static constexpr uint32_t index = 2;
+                };
+
+                struct n3Stars
+                {
+                    static constexpr std::string_view name = "3_stars";
+                    static constexpr uint32_t index = 3;
+                };
+
+                struct n2Stars
+                {
+                    static constexpr std::string_view name = "2_stars";
+                    static constexpr uint32_t index = 4;
+                };
+
+                struct n1Star
+                {
+                    static constexpr std::string_view name = "1_star";
+                    static constexpr uint32_t index = 5;
+                };
+
+                struct IdleEmpty
+                {
+                    static constexpr std::string_view name = "Idle_empty";
+                    static constexpr uint32_t index = 6;
+                };
+            };
+
+            struct state_machines
+            {
+                static constexpr uint32_t count = 1;
+                static constexpr std::string_view names[1] = {
+                    "State Machine 1",
+                };
+                static constexpr uint32_t seeds[1] = {
+                    1,
+                };
+                static constexpr int32_t slots[1] = {
+                    0,
+                };
+                static constexpr int32_t indexOf(std::string_view name)
+                {
+                    return detail::lookup<1>(names, seeds, slots, name);
+                }
+
+                struct StateMachine1
+                {
+                    static constexpr std::string_view name = "State Machine 1";
+                    static constexpr uint32_t index = 0;
+
+                    struct inputs
+                    {
+                        static constexpr uint32_t count = 1;
+                        static constexpr std::string_view names[1] = {
+                            "Rating",
+                        };
+                        static constexpr uint32_t seeds[1] = {
+                            1,
+                        };
+                        static constexpr int32_t slots[1] = {
+                            0,
+                        };
+                        static constexpr int32_t indexOf(std::string_view name)
+                        {
+                            return detail::lookup<1>(names, seeds, slots, name);
+                        }
+
+                        struct Rating
+                        {
+                            static constexpr std::string_view name = "Rating";
+                            static constexpr uint32_t index = 0;
+                            static constexpr InputType type = InputType::number;
+                        };
+                    };
+                };
+            };
+
+            struct text_runs
+            {
+            };
+        };
+    };
+};
+} // namespace rive_generated
@@ -0,0 +1,67 @@
+// rive_generated.dart
+
+// ignore_for_file: lines_longer_than_80_chars, unused_field
+
+// ignore: avoid_classes_with_only_static_members
+/// Main entry point for accessing Rive metadata.
+/// This class provides static getters for each Rive file's metadata.
+abstract class RiveMeta {
+  /// Getter for the metadata of the stdin Rive file.
+  static const _StdinFile stdin = _StdinFile();
+
+}
+
+// ----------------------
+// stdin Rive file
+// ----------------------
+
+/// Metadata for the "stdin" Rive file.
+class _StdinFile {
+  const _StdinFile();
+
+  _StdinArtboards get artboards => const _StdinArtboards();
+}
+
+/// Container for all artboards in the "stdin" Rive file.
+class _StdinArtboards {
+  const _StdinArtboards();
+
+  _StdinArtboardComplete get complete => const _StdinArtboardComplete();
+}
+
+/// Metadata for the "complete" artboard.
+class _StdinArtboardComplete {
+  const _StdinArtboardComplete();
+
+  String get name => 'Complete';
+
+  _StdinCompleteAnimations get animations => const _StdinCompleteAnimations();
+  _StdinCompleteStateMachines get stateMachines => const _StdinCompleteStateMachines();
+}
+
+/// Container for animation names in the "complete" artboard.
+class _StdinCompleteAnimations {
+  const _StdinCompleteAnimations();
+
+  String get thumbnail => 'Thumbnail';
+  String get n5Stars => '5_stars';
+  String get n4Stars => '4_stars';
+  String get n3Stars => '3_stars';
+  String get n2Stars => '2_stars';
+  String get n1Star => '1_star';
+  String get idleEmpty => 'Idle_empty';
+}
+
+/// Container for state machines in the "complete" artboard.
+class _StdinCompleteStateMachines {
+  const _StdinCompleteStateMachines();
+
+  _StdinCompletestateMachine1 get stateMachine1 => const _StdinCompletestateMachine1();
+}
+
+/// Metadata for the "stateMachine1" state machine.
+class _StdinCompletestateMachine1 {
+  const _StdinCompletestateMachine1();
+
+  String get name => 'State Machine 1';
+}
@@ -0,0 +1,315 @@
+// Checks the vectorized escapers in src/string_escape.cpp against the
+// byte-at-a-time implementations they replace, for every kernel the CPU
+// supports. Run with --benchmark to compare their throughput instead.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "kainjow/mustache.hpp"
+#include "string_escape.h"
+
+// The original sanitizeString from main.cpp
+static std::string referenceSanitizeString(const std::string& input)
+{
+    std::string output;
+    for (char c : input)
+    {
+        switch (c)
+        {
+            case '\n':
+                output += "\\n";
+                break;
+            case '\r':
+                output += "\\r";
+                break;
+            case '\t':
+                output += "\\t";
+                break;
+            case '\"':
+                output += "\\\"";
+                break;
+            case '\\':
+                output += "\\\\";
+                break;
+            default:
+                if (std::isprint(c))
+                {
+                    output += c;
+                }
+                else
+                {
+                    char hex[7];
+                    std::snprintf(hex,
+                                  sizeof(hex),
+                                  "\\u%04x",
+                                  static_cast<unsigned char>(c));
+                    output += hex;
+                }
+        }
+    }
+    return output;
+}
+
+static std::string referenceHtmlEscape(const std::string& input)
+{
+    return kainjow::mustache::html_escape(input);
+}
+
+static std::string referenceJsonEscape(const std::string& input)
+{
+    std::string output;
+    for (char c : input)
+    {
+        auto byte = static_cast<unsigned char>(c);
+        switch (c)
+        {
+            case '"':
+                output += "\\\"";
+                break;
+            case '\\':
+                output += "\\\\";
+                break;
+            case '\n':
+                output += "\\n";
+                break;
+            case '\r':
+                output += "\\r";
+                break;
+            case '\t':
+                output += "\\t";
+                break;
+            default:
+                if (byte < 0x20)
+                {
+                    char hex[7];
+                    std::snprintf(hex, sizeof(hex), "\\u%04x", byte);
+                    output += hex;
+                }
+                else
+                {
+                    output += c;
+                }
+        }
+    }
+    return output;
+}
+
+static std::string jsonEscape(const std::string& input)
+{
+    std::string output;
+    appendJsonEscaped(output, input);
+    return output;
+}
+
+static std::string htmlEscapeAppended(const std::string& input)
+{
+    std::string output;
+    appendHtmlEscaped(output, input);
+    return output;
+}
+
+static const char* kernelName(EscapeKernel kernel)
+{
+    switch (kernel)
+    {
+        case EscapeKernel::Scalar:
+            return "scalar";
+        case EscapeKernel::SSE2:
+            return "SSE2";
+        case EscapeKernel::AVX2:
+            return "AVX2";
+    }
+    return "unknown";
+}
+
+static const EscapeKernel allKernels[] = {
+    EscapeKernel::Scalar,
+    EscapeKernel::SSE2,
+    EscapeKernel::AVX2,
+};
+
+static int failures = 0;
+
+static void check(const std::string& input)
+{
+    struct Escaper
+    {
+        const char* name;
+        std::string (*escape)(const std::string&);
+        std::string (*reference)(const std::string&);
+    };
+    static const Escaper escapers[] = {
+        {"sanitizeString", sanitizeString, referenceSanitizeString},
+        {"htmlEscape", htmlEscape, referenceHtmlEscape},
+        {"appendHtmlEscaped", htmlEscapeAppended, referenceHtmlEscape},
+        {"appendJsonEscaped", jsonEscape, referenceJsonEscape},
+    };
+
+    for (const auto& escaper : escapers)
+    {
+        if (escaper.escape(input) != escaper.reference(input))
+        {
+            if (failures++ < 10)
+            {
+                std::cout << escaper.name << " mismatch with the "
+                          << kernelName(escapeKernel())
+                          << " kernel for input of length " << input.size()
+                          << ":";
+                for (unsigned char c : input)
+                {
+                    std::printf(" %02x", c);
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+}
+
+static void runTests()
+{
+    std::mt19937 random(1234);
+    const std::string alphabet = "abcXYZ 019&<>\"'\\\n\r\t\x01\x1f\x7f\x80\xc3"
+                                 "\xa9\xff?{}";
+
+    for (auto kernel : allKernels)
+    {
+        if (!setEscapeKernel(kernel))
+        {
+            continue;
+        }
+
+        // Every byte value at every position of strings up to twice the
+        // widest vector, covering the vector loops and scalar tails
+        for (size_t length = 0; length <= 70; length++)
+        {
+            for (size_t position = 0; position < length; position++)
+            {
+                for (int byte = 0; byte < 256; byte++)
+                {
+                    std::string input(length, 'a');
+                    input[position] = static_cast<char>(byte);
+                    check(input);
+                }
+            }
+        }
+
+        // Every pair of byte values straddling the 16 and 32 byte boundaries
+        for (size_t position : {15, 31})
+        {
+            for (int first = 0; first < 256; first++)
+            {
+                for (int second = 0; second < 256; second++)
+                {
+                    std::string input(40, 'a');
+                    input[position] = static_cast<char>(first);
+                    input[position + 1] = static_cast<char>(second);
+                    check(input);
+                }
+            }
+        }
+
+        // Random strings dense with characters that need escaping
+        for (int i = 0; i < 20000; i++)
+        {
+            std::string input(random() % 300, ' ');
+            for (auto& c : input)
+            {
+                c = random() % 4 == 0 ? static_cast<char>(random() % 256)
+                                      : alphabet[random() % alphabet.size()];
+            }
+            check(input);
+        }
+    }
+
+    if (failures == 0)
+    {
+        std::cout << "All escaping kernels match the reference implementations"
+                  << std::endl;
+    }
+}
+
+template <typename Function>
+static void benchmark(const char* name,
+                      const std::vector<std::string>& inputs,
+                      Function escape)
+{
+    size_t bytes = 0;
+    size_t outputBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < 20; iteration++)
+    {
+        for (const auto& input : inputs)
+        {
+            bytes += input.size();
+            outputBytes += escape(input).size();
+        }
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::printf("  %-24s %8.1f MB/s  (%zu bytes out)\n",
+                name,
+                bytes / elapsed.count() / (1024 * 1024),
+                outputBytes);
+}
+
+static void runBenchmark()
+{
+    // Long localized paragraphs with the occasional escape, as in text run
+    // defaults, plus many short identifiers, as in names
+    std::vector<std::string> paragraphs;
+    const std::string sentence = "Willkommen zur\xc3\xbc"
+                                 "ck! Tap \"Play\" to start the next level. ";
+    for (int i = 0; i < 200; i++)
+    {
+        std::string paragraph;
+        while (paragraph.size() < 36 * 1024)
+        {
+            paragraph += sentence;
+            if (paragraph.size() % 7 == 0)
+            {
+                paragraph += "\n";
+            }
+        }
+        paragraphs.push_back(paragraph);
+    }
+    std::vector<std::string> names;
+    for (int i = 0; i < 200000; i++)
+    {
+        names.push_back("State Machine " + std::to_string(i));
+    }
+
+    for (const auto* inputs : {&paragraphs, &names})
+    {
+        std::cout << (inputs == &paragraphs ? "Paragraphs" : "Names")
+                  << std::endl;
+        benchmark("reference sanitize", *inputs, referenceSanitizeString);
+        benchmark("reference html", *inputs, referenceHtmlEscape);
+        for (auto kernel : allKernels)
+        {
+            if (!setEscapeKernel(kernel))
+            {
+                continue;
+            }
+            std::string name = kernelName(kernel);
+            benchmark((name + " sanitize").c_str(), *inputs, sanitizeString);
+            benchmark((name + " html").c_str(), *inputs, htmlEscape);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::strcmp(argv[1], "--benchmark") == 0)
+    {
+        runBenchmark();
+        return 0;
+    }
+
+    runTests();
+    return failures == 0 ? 0 : 1;
+}
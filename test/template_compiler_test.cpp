@@ -0,0 +1,430 @@
+// Checks that compiled templates (src/template_compiler.cpp) render exactly
+// what kainjow::mustache renders, for the bundled templates and for random
+// templates mixing sections, whitespace and standalone tags. Pass template
+// files as arguments to check them too. Run with --benchmark [template] to
+// compare rendering speed instead.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "default_template.h"
+#include "kainjow/mustache.hpp"
+#include "rive_file_data.h"
+#include "string_escape.h"
+#include "template_compiler.h"
+#include "template_data.h"
+
+using Data = kainjow::mustache::data;
+
+static int failures = 0;
+
+// A made up name for element `index`, with characters that need escaping
+static std::string makeName(const char* prefix, size_t index)
+{
+    static const char* suffixes[] = {"", " & co", "<b>", "\"quoted\"", "it's"};
+    return prefix + std::to_string(index) + suffixes[index % 5];
+}
+
+static std::shared_ptr<const EnumInfo> makeEnum(size_t index)
+{
+    EnumInfo enumInfo;
+    enumInfo.name = makeName("Enum", index);
+    for (size_t v = 0; v < 3; v++)
+    {
+        enumInfo.values.push_back({makeName("key", v)});
+    }
+    return std::make_shared<const EnumInfo>(std::move(enumInfo));
+}
+
+static std::shared_ptr<const ViewModelInfo> makeViewModel(size_t index)
+{
+    static const char* propertyTypes[] = {"viewModel",
+                                          "enum",
+                                          "string",
+                                          "number",
+                                          "integer",
+                                          "boolean",
+                                          "color",
+                                          "list",
+                                          "trigger"};
+    ViewModelInfo viewModel;
+    viewModel.name = makeName("Model", index);
+    for (size_t p = 0; p < std::size(propertyTypes); p++)
+    {
+        viewModel.properties.push_back(
+            {makeName("prop", p), propertyTypes[p], makeName("Backing", p)});
+    }
+    return std::make_shared<const ViewModelInfo>(std::move(viewModel));
+}
+
+// Artboard `index` of `count`, with list sizes varied by `variant`
+static std::shared_ptr<const ArtboardData> makeArtboard(size_t index,
+                                                        size_t count,
+                                                        size_t variant)
+{
+    ArtboardData artboard;
+    artboard.artboardName = makeName("Artboard ", index);
+    artboard.artboardPascalCase = makeName("Artboard", index);
+    artboard.artboardCameCase = makeName("artboard", index);
+    artboard.artboardSnakeCase = makeName("artboard_", index);
+    artboard.artboardKebabCase = makeName("artboard-", index);
+
+    for (size_t a = 0; a < (index + variant) % (count + 1); a++)
+    {
+        artboard.animations.push_back(makeName("Anim ", a));
+    }
+    for (size_t s = 0; s < count; s++)
+    {
+        std::vector<InputInfo> inputs;
+        for (size_t i = 0; i < s % 4; i++)
+        {
+            inputs.push_back({makeName("Input ", i),
+                              i % 2 ? "boolean" : "number",
+                              i % 2 ? "false" : "0"});
+        }
+        artboard.stateMachines.emplace_back(makeName("SM ", s),
+                                            std::move(inputs));
+    }
+    for (size_t t = 0; t < index % 3; t++)
+    {
+        artboard.textValueRuns.push_back(
+            {makeName("Run ", t), "Hello\n\"World\" & <you>"});
+    }
+    // Instances of the next artboard, which runs are found through
+    for (size_t n = 0; n < index % 2 && count > 1; n++)
+    {
+        size_t target = (index + 1) % count;
+        artboard.nestedArtboards.push_back(
+            {makeName("Nested ", n), makeName("Artboard ", target), target});
+        artboard.nestedTextValueRuns.push_back(
+            {makeName("Run ", n), makeName("Nested ", n) + "/Run 0"});
+    }
+    return std::make_shared<const ArtboardData>(std::move(artboard));
+}
+
+// Files made up of `scale` artboards each, with some lists left empty. Even
+// artboards, the first enum and the first view model are the same objects in
+// every file that has them, so they're shared like interned structures.
+static std::vector<RiveFileData> makeFiles(size_t files, size_t scale)
+{
+    std::vector<std::shared_ptr<const ArtboardData>> sharedArtboards;
+    for (size_t b = 0; b < scale; b++)
+    {
+        sharedArtboards.push_back(makeArtboard(b, scale, 0));
+    }
+
+    std::vector<RiveFileData> rivFiles;
+    for (size_t f = 0; f < files; f++)
+    {
+        RiveFileData file;
+        file.rivName = makeName("file ", f);
+        file.rivPascalCase = makeName("File", f);
+        file.rivCameCase = makeName("file", f);
+        file.riveSnakeCase = makeName("file_", f);
+        file.rivKebabCase = makeName("file-", f);
+        file.fingerprint = 0x9e3779b97f4a7c15ull * (f + 1);
+
+        for (size_t e = 0; e < (f + 1) % 3; e++)
+        {
+            static const auto sharedEnum = makeEnum(0);
+            file.enums.push_back(e == 0 ? sharedEnum : makeEnum(e));
+        }
+        for (size_t m = 0; m < f % 3; m++)
+        {
+            static const auto sharedViewModel = makeViewModel(0);
+            file.viewmodels.push_back(m == 0 ? sharedViewModel
+                                             : makeViewModel(m));
+        }
+        for (size_t a = 0; a < f % 2; a++)
+        {
+            file.assets.push_back({makeName("asset", a),
+                                   "image",
+                                   "png",
+                                   std::to_string(a),
+                                   "",
+                                   "https://cdn.example.com"});
+        }
+        for (size_t b = 0; b < scale; b++)
+        {
+            file.artboards.push_back(b % 2 ? makeArtboard(b, scale, f)
+                                           : sharedArtboards[b]);
+        }
+        rivFiles.push_back(std::move(file));
+    }
+    return rivFiles;
+}
+
+// The data buildTemplateData gives templates for makeFiles(files, scale)
+static Data makeTemplateData(size_t files, size_t scale)
+{
+    return buildTemplateData(makeFiles(files, scale));
+}
+
+static std::string interpret(const std::string& source, const Data& data)
+{
+    kainjow::mustache::mustache tmpl(source);
+    tmpl.set_custom_escape(htmlEscape);
+    return tmpl.render(data);
+}
+
+static bool renderCompiled(const std::string& source,
+                           const Data& data,
+                           std::string& output)
+{
+    auto compiled = CompiledTemplate::compile(source);
+    return compiled && compiled->render(data, appendHtmlEscaped, output);
+}
+
+// Compares the two renderers. Returns false if the template didn't compile.
+static bool check(const std::string& name,
+                  const std::string& source,
+                  const Data& data)
+{
+    std::string compiled;
+    if (!renderCompiled(source, data, compiled))
+    {
+        return false;
+    }
+    if (compiled != interpret(source, data) && failures++ < 10)
+    {
+        std::cout << "Compiled output differs from kainjow for " << name
+                  << ":\n"
+                  << source << std::endl;
+    }
+    return true;
+}
+
+static void expectCompiled(const std::string& name,
+                           const std::string& source,
+                           const Data& data)
+{
+    if (!check(name, source, data) && failures++ < 10)
+    {
+        std::cout << "Failed to compile " << name << std::endl;
+    }
+}
+
+static void expectFallback(const std::string& name,
+                           const std::string& source,
+                           const Data& data)
+{
+    std::string output;
+    if (renderCompiled(source, data, output) && failures++ < 10)
+    {
+        std::cout << "Expected " << name << " not to compile" << std::endl;
+    }
+}
+
+static const char* randomNames[] = {
+    "riv_files",
+    "artboards",
+    "state_machines",
+    "inputs",
+    "view_models",
+    "properties",
+    "property_type",
+    "is_string",
+    "property_type.is_string",
+    "property_type.backing_name",
+    "enums",
+    "enum_values",
+    "last",
+    "riv_pascal_case",
+    "artboard_name",
+    "input_name",
+    "text_value_runs",
+    "text_value_run_default",
+    "generated_file_name",
+    "riv_fingerprint",
+    "artboard_index",
+    "is_shared",
+    "shared_enums",
+    "shared_view_models",
+    "shared_artboards",
+    "nested_artboards",
+    "nested_artboard_index",
+    "missing",
+    "missing.name",
+    ".",
+};
+
+static std::string randomTemplate(std::mt19937& random, int depth)
+{
+    static const char* text[] = {"x", "yz", " ", "  ", "\t", "\n", "\r\n",
+                                 "\n", "<&>"};
+    std::string source;
+    int parts = random() % 8;
+    for (int i = 0; i < parts; i++)
+    {
+        std::string name = randomNames[random() % std::size(randomNames)];
+        switch (random() % 10)
+        {
+            case 0:
+            case 1:
+            case 2:
+                source += text[random() % std::size(text)];
+                break;
+            case 3:
+                source += "{{" + name + "}}";
+                break;
+            case 4:
+                source += random() % 2 ? "{{{" + name + "}}}"
+                                       : "{{& " + name + " }}";
+                break;
+            case 5:
+                source += random() % 2 ? "{{! comment }}"
+                                       : "{{=<% %>=}}<%" + name +
+                                             "%><%={{ }}=%>";
+                break;
+            default:
+                if (depth < 4)
+                {
+                    if (name == ".")
+                    {
+                        name = "last";
+                    }
+                    source += (random() % 3 ? "{{#" : "{{^") + name + "}}";
+                    source += randomTemplate(random, depth + 1);
+                    source += "{{/" + name + "}}";
+                }
+                break;
+        }
+    }
+    return source;
+}
+
+static bool readFile(const char* path, std::string& contents)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::cout << "Unable to read " << path << std::endl;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+static void runTests(int argc, char* argv[])
+{
+    std::vector<Data> datasets;
+    datasets.push_back(makeTemplateData(1, 1));
+    datasets.push_back(makeTemplateData(3, 3));
+    datasets.push_back(makeTemplateData(5, 0));
+
+    for (const auto& data : datasets)
+    {
+        expectCompiled("the default Dart template",
+                       default_templates::DEFAULT_DART_TEMPLATE,
+                       data);
+        for (int i = 1; i < argc; i++)
+        {
+            std::string source;
+            if (!readFile(argv[i], source))
+            {
+                failures++;
+                continue;
+            }
+            expectCompiled(argv[i], source, data);
+        }
+
+        std::mt19937 random(1234);
+        for (int i = 0; i < 20000; i++)
+        {
+            check("a random template", randomTemplate(random, 0), data);
+        }
+    }
+
+    const Data& data = datasets[1];
+    expectFallback("a partial", "{{#riv_files}}{{>artboards}}{{/riv_files}}",
+                   data);
+    expectFallback("an invalid template", "{{#riv_files}}", data);
+    expectFallback("a section over {{.}}", "{{#.}}x{{/.}}", data);
+    // Shared artboards have no index, so kainjow finds the enclosing one's
+    expectFallback("an index shared artboards don't have",
+                   "{{#riv_files}}{{#artboards}}{{#shared_artboards}}"
+                   "{{artboard_index}}"
+                   "{{/shared_artboards}}{{/artboards}}{{/riv_files}}",
+                   data);
+
+    // Names only some records define resolve differently per record
+    Data partial = makeTemplateData(2, 2);
+    Data rivFiles{Data::type::list};
+    Data first = partial["riv_files"].list_value()[0];
+    first["optional"] = "set";
+    rivFiles.push_back(first);
+    rivFiles.push_back(partial["riv_files"].list_value()[1]);
+    partial.set("riv_files", rivFiles);
+    expectFallback("a name only some records define",
+                   "{{#riv_files}}{{optional}}{{/riv_files}}",
+                   partial);
+    expectCompiled("a name no record references",
+                   "{{#riv_files}}{{riv_camel_case}}{{/riv_files}}",
+                   partial);
+
+    if (failures == 0)
+    {
+        std::cout << "All compiled templates match kainjow" << std::endl;
+    }
+}
+
+static void runBenchmark(const std::string& source)
+{
+    auto data = makeTemplateData(100, 12);
+    const int iterations = 5;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t interpretedBytes = 0;
+    for (int i = 0; i < iterations; i++)
+    {
+        interpretedBytes += interpret(source, data).size();
+    }
+    std::chrono::duration<double> interpreted =
+        std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    size_t compiledBytes = 0;
+    for (int i = 0; i < iterations; i++)
+    {
+        std::string output;
+        renderCompiled(source, data, output);
+        compiledBytes += output.size();
+    }
+    std::chrono::duration<double> compiled =
+        std::chrono::steady_clock::now() - start;
+
+    std::printf("  kainjow   %8.1f ms  (%zu bytes out)\n",
+                interpreted.count() * 1000 / iterations,
+                interpretedBytes / iterations);
+    std::printf("  compiled  %8.1f ms  (%zu bytes out)\n",
+                compiled.count() * 1000 / iterations,
+                compiledBytes / iterations);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::strcmp(argv[1], "--benchmark") == 0)
+    {
+        std::string source = default_templates::DEFAULT_DART_TEMPLATE;
+        if (argc > 2 && !readFile(argv[2], source))
+        {
+            return 1;
+        }
+        runBenchmark(source);
+        return 0;
+    }
+
+    runTests(argc, argv);
+    return failures == 0 ? 0 : 1;
+}
@@ -18,6 +18,10 @@ fi
 
 # Define the command as a reusable variable
 RIVE_GENERATOR="../build/out/lib/release/rive_code_generator"
+STRING_ESCAPE_TEST="../build/out/lib/release/string_escape_test"
+TEMPLATE_COMPILER_TEST="../build/out/lib/release/template_compiler_test"
+ALLOCATION_TEST="../build/out/lib/release/allocation_test"
+CODEGEN_API_TEST="../build/out/lib/release/codegen_api_test"
 
 # Add a new variable for the update flag
 UPDATE_EXPECTED=false
@@ -99,6 +103,83 @@ run_test "All JSON" "$RIVE_GENERATOR -i ../samples/ -t ../templates/json_templat
 
 # Generate correct Dart output for a single .riv file
 run_test "Rating Dart" "$RIVE_GENERATOR -i ../samples/rating.riv -t ../templates/dart_template.mustache" "expected/rating.dart" "output/rating.dart"
+
+# Streaming renders each file as it's read, with the same output
+run_test "All JSON Streaming" "$RIVE_GENERATOR -i ../samples/ -t ../templates/json_template.mustache --stream" "expected/all.json" "output/all_streamed.json"
+run_test "Rating Dart Streaming" "$RIVE_GENERATOR -i ../samples/rating.riv -t ../templates/dart_template.mustache --stream" "expected/rating.dart" "output/rating_streamed.dart"
+
+# The library's C API renders what the command line tool does
+run_test "Rating Dart C API" "$CODEGEN_API_TEST ../templates/dart_template.mustache ../samples/rating.riv" "expected/rating.dart"
+
+# Indices for binding by index match the runtime's order, and the
+# fingerprint lets generated code check it loaded the same file
+run_test "Rating Indices" "$RIVE_GENERATOR -i ../samples/rating.riv -t templates/indices.mustache -o output/rating_indices.txt > /dev/null && cat output/rating_indices.txt && rm -f output/rating_indices.txt" "expected/rating_indices.txt"
+
+# Nested artboards point to the artboards they're instances of by index,
+# and unnamed ones aren't listed
+run_test "Nested Artboards" "$RIVE_GENERATOR -i ../samples/nested_text.riv -t templates/nested_artboards.mustache -o output/nested_artboards.txt > /dev/null && cat output/nested_artboards.txt && rm -f output/nested_artboards.txt" "expected/nested_artboards.txt"
+
+# The profile's counts are deterministic, its times aren't
+run_test "Rating Template Profile" "$RIVE_GENERATOR -i ../samples/rating.riv -t templates/profile.mustache -o output/profile.txt --profile-template | sed -n '/^Template profile/,/^Total/p' | sed -E 's/ +[0-9]+\\.[0-9]{3}\$//' && rm -f output/profile.txt" "expected/template_profile.txt"
+
+# Tar archives are read entry by entry, without unpacking them to disk
+run_test "Rating Dart Tar" "mkdir -p output/tar && cp ../samples/rating.riv output/tar/ && tar -cf output/tar/rating.tar -C output/tar rating.riv && $RIVE_GENERATOR -i output/tar/rating.tar -t ../templates/dart_template.mustache -o output/rating_tar.dart > /dev/null && cat output/rating_tar.dart && rm -rf output/tar output/rating_tar.dart" "expected/rating.dart"
+
+# A file piped to stdin is named "stdin" in the output
+run_test "Rating Dart Stdin" "cat ../samples/rating.riv | $RIVE_GENERATOR -i - -t ../templates/dart_template.mustache -o output/rating_stdin.dart > /dev/null && cat output/rating_stdin.dart && rm -f output/rating_stdin.dart" "expected/rating_stdin.dart"
+
+# Shards extracted separately merge into what a single run generates
+run_test "All JSON Sharded" "for shard in 0 1 2; do $RIVE_GENERATOR -i ../samples/ -t ../templates/json_template.mustache --shard \$shard/3 -o output/shard\$shard.bin > /dev/null; done && $RIVE_GENERATOR --merge output/shard0.bin output/shard1.bin output/shard2.bin -t ../templates/json_template.mustache -o output/all_merged.json > /dev/null && cat output/all_merged.json && rm -f output/shard*.bin output/all_merged.json" "expected/all.json"
+
+# Files extracted in worker processes render as they do in process
+run_test "All JSON Isolated" "$RIVE_GENERATOR -i ../samples/ -t ../templates/json_template.mustache --isolate" "expected/all.json" "output/all_isolated.json"
+
+# Files too large for a worker's memory are reported and skipped, and the
+# run still finishes
+run_test "Isolated Out Of Memory" "mkdir -p output/oom && dd if=/dev/zero of=output/oom/a.riv bs=1048576 count=16 2> /dev/null && dd if=/dev/zero of=output/oom/b.riv bs=1048576 count=16 2> /dev/null && $RIVE_GENERATOR -i output/oom -l json --isolate --isolate-memory 1 -o output/oom.json 2>&1 | sort && cat output/oom.json && rm -rf output/oom output/oom.json" "expected/isolated_out_of_memory.txt"
+
+# The built-in Dart template, compiled into C++ at build time
+run_test "Rating Dart Built-in" "$RIVE_GENERATOR -i ../samples/rating.riv -l dart" "expected/rating_builtin.dart" "output/rating_builtin.dart"
+
+# The compiled-in Dart template renders what kainjow renders from the
+# template data, for every sample
+run_test "All Dart Built-in Matches Template" "$RIVE_GENERATOR -i ../samples/ -l dart -o output/all_builtin.dart > /dev/null && $RIVE_GENERATOR -i ../samples/ -l dart --profile-template -o output/all_template.dart > /dev/null && diff output/all_builtin.dart output/all_template.dart && echo 'Outputs match'; rm -f output/all_builtin.dart output/all_template.dart" "expected/builtin_matches_template.txt"
+
+# Generate a C++ header with the built-in C++ generator
+run_test "Rating C++" "$RIVE_GENERATOR -i ../samples/rating.riv -l cpp" "expected/rating.hpp" "output/rating.hpp"
+
+# Generate JSON output with the built-in JSON generator
+run_test "Rating JSON" "$RIVE_GENERATOR -i ../samples/rating.riv -l json" "expected/rating.json" "output/rating.json"
+
+# The built-in JSON generator over every sample, enums and view models too
+run_test "All JSON Built-in" "$RIVE_GENERATOR -i ../samples/ -l json" "expected/all_builtin.json" "output/all_builtin.json"
+
+# --only overrides the parts of the files the output would extract
+run_test "Rating JSON Only State Machines" "$RIVE_GENERATOR -i ../samples/rating.riv -l json --only state_machines" "expected/rating_state_machines.json" "output/rating_state_machines.json"
+
+# Generate a Make-format depfile listing the inputs of the output
+run_test "Rating Depfile" "$RIVE_GENERATOR -i ../samples/rating.riv -t ../templates/dart_template.mustache -o output/rating.dart --depfile output/rating.d > /dev/null && cat output/rating.d && rm -f output/rating.dart output/rating.d" "expected/rating.d"
+
+# Identical artboards, enums and view models across files are flagged as shared
+run_test "Shared Structures" "mkdir -p output/shared && cp ../samples/rating.riv output/shared/a.riv && cp ../samples/rating.riv output/shared/b.riv && $RIVE_GENERATOR -i output/shared -t templates/shared_structures.mustache -o output/shared.txt > /dev/null && cat output/shared.txt && rm -rf output/shared output/shared.txt" "expected/shared_structures.txt"
+
+# Files are matched by name when diffing directories
+run_test "Diff Directories" "mkdir -p output/diff/before output/diff/after && cp ../samples/rating.riv output/diff/before/a.riv && cp ../samples/rating.riv output/diff/before/b.riv && cp ../samples/rating.riv output/diff/after/b.riv && cp ../samples/rating.riv output/diff/after/c.riv && $RIVE_GENERATOR --diff output/diff/before output/diff/after && rm -rf output/diff" "expected/diff_files.txt"
+
+# Files with the same name are compared part by part. Each copy is edited:
+# Snake and isTall renamed, custom_image renamed, NestedArtboard2 pointed at
+# Artboard3, Thumbnail renamed and Rating given a default of 3, and one "Text
+# run 1" changed and Artboard-Nr2 renamed.
+run_test "Diff Structure" "mkdir -p output/diff/before output/diff/after && cp ../samples/db_generator.riv ../samples/file_assets.riv ../samples/nested_text.riv ../samples/rating.riv ../samples/text_runs.riv output/diff/before/ && perl -0777 -pe 's/Snake/Snail/; s/isTall/isLong/' ../samples/db_generator.riv > output/diff/after/db_generator.riv && perl -0777 -pe 's/custom_image/custom_photo/' ../samples/file_assets.riv > output/diff/after/file_assets.riv && perl -0777 -pe 's/\xc5\x01\x03/\xc5\x01\x02/' ../samples/nested_text.riv > output/diff/after/nested_text.riv && perl -0777 -pe 's/Thumbnail/Preview_1/; s/\x38\x8a\x01\x06Rating/\$&\x8c\x01\x00\x00\x40\x40/' ../samples/rating.riv > output/diff/after/rating.riv && perl -0777 -pe 's/Text run 1/Text run 9/; s/Artboard-Nr2/Artboard-Nr3/' ../samples/text_runs.riv > output/diff/after/text_runs.riv && $RIVE_GENERATOR --diff output/diff/before output/diff/after && rm -rf output/diff" "expected/diff_structure.txt"
+
+# Vectorized string escaping matches the original implementations
+run_test "String Escaping" "$STRING_ESCAPE_TEST" "expected/string_escape.txt"
+
+# Compiled templates render exactly what kainjow renders
+run_test "Template Compiler" "$TEMPLATE_COMPILER_TEST ../templates/*.mustache" "expected/template_compiler.txt"
+
+# Extracted data moves through to the template without being copied
+run_test "Allocations" "$ALLOCATION_TEST ../samples/rewards.riv" "expected/allocations.txt"
 #endregion
 
 # Exit with an error if any test failed
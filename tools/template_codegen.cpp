@@ -0,0 +1,772 @@
+// Turns the built-in templates of default_template.h into C++ render
+// functions at build time, so that the default outputs are written straight
+// into the output buffer without parsing a template or looking names up.
+//
+// Usage: template_codegen <output.cpp>
+//
+// Names are resolved against templateDataSchema(), the description of the
+// template data that the compiled templates of template_compiler.cpp use
+// too, so the generated functions render exactly what kainjow renders for
+// that data. A built-in template using a name the schema doesn't have, or
+// one only the runtime can compute, fails the build instead of silently
+// rendering nothing.
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "default_template.h"
+#include "kainjow/mustache.hpp"
+#include "template_schema.h"
+
+using Component = kainjow::mustache::component<std::string>;
+using TagType = kainjow::mustache::tag_type;
+
+// A name of the template data, with the C++ expression that computes it over
+// the current item, written as $. For list items, $u is the item's name made
+// unique among the items of its list, and $i is its index in the list.
+struct Field
+{
+    std::string name;
+    TemplateFieldKind kind;
+    // Empty for names the built-in templates can't render
+    std::string expression;
+    // Type of the items of a List, or of an Object
+    std::string type;
+    // Whether a List holds shared_ptrs to its items
+    bool shared = false;
+};
+
+struct Type
+{
+    // What's made unique among the items of a list, if anything
+    std::string uniqueName;
+    std::vector<Field> fields;
+};
+
+// How the names of one type of record are computed
+struct TypeExpressions
+{
+    std::string uniqueName;
+    // Expression, and whether it's a list of shared_ptrs, by name
+    std::map<std::string, std::pair<std::string, bool>> fields;
+};
+
+static void addCaseExpressions(TypeExpressions& type,
+                               const std::string& prefix,
+                               const std::string& expression)
+{
+    type.fields[prefix + "_camel_case"] = {"toCamelCase(" + expression + ")",
+                                           false};
+    type.fields[prefix + "_pascal_case"] = {"toPascalCase(" + expression + ")",
+                                            false};
+    type.fields[prefix + "_snake_case"] = {"toSnakeCase(" + expression + ")",
+                                           false};
+    type.fields[prefix + "_kebab_case"] = {"toKebabCase(" + expression + ")",
+                                           false};
+}
+
+// The expressions for the names of templateDataSchema(), mirroring
+// template_data.cpp. is_shared and the shared_* lists have none, since they
+// need every file up front, and `last` comes from the enclosing list.
+static std::map<std::string, TypeExpressions> templateDataExpressions()
+{
+    std::map<std::string, TypeExpressions> types;
+
+    types["Root"].fields = {
+        {"generated_file_name", {"generatedFileName", false}},
+        {"riv_files", {"files", false}},
+    };
+
+    types["File"].fields = {
+        {"riv_pascal_case", {"$.rivPascalCase", false}},
+        {"riv_camel_case", {"$.rivCameCase", false}},
+        {"riv_snake_case", {"$.riveSnakeCase", false}},
+        {"riv_kebab_case", {"$.rivKebabCase", false}},
+        {"generated_file_name", {"generatedFileName", false}},
+        {"riv_fingerprint", {"fingerprintString($.fingerprint)", false}},
+        {"enums", {"$.enums", true}},
+        {"view_models", {"$.viewmodels", true}},
+        {"assets", {"$.assets", false}},
+        {"artboards", {"$.artboards", true}},
+    };
+
+    auto& asset = types["Asset"];
+    asset.fields["asset_name"] = {"$.name", false};
+    addCaseExpressions(asset, "asset", "$.name");
+    asset.fields["asset_type"] = {"$.type", false};
+    asset.fields["asset_id"] = {"$.assetId", false};
+    asset.fields["asset_cdn_uuid"] = {"$.cdnUuid", false};
+    asset.fields["asset_cdn_base_url"] = {"$.cdnBaseUrl", false};
+
+    auto& enumType = types["Enum"];
+    enumType.fields["enum_name"] = {"$.name", false};
+    addCaseExpressions(enumType, "enum", "$.name");
+    enumType.fields["enum_values"] = {"$.values", false};
+
+    auto& enumValue = types["EnumValue"];
+    enumValue.fields["enum_value_key"] = {"$.key", false};
+    addCaseExpressions(enumValue, "enum_value", "$.key");
+
+    auto& viewModel = types["ViewModel"];
+    viewModel.fields["view_model_name"] = {"$.name", false};
+    addCaseExpressions(viewModel, "view_model", "$.name");
+    viewModel.fields["properties"] = {"$.properties", false};
+
+    auto& property = types["Property"];
+    property.fields["property_name"] = {"$.name", false};
+    addCaseExpressions(property, "property", "$.name");
+    property.fields["property_index"] = {"std::to_string($i)", false};
+    property.fields["property_type"] = {"$", false};
+
+    auto& propertyType = types["PropertyType"];
+    for (const char* type : {"view_model",
+                             "enum",
+                             "string",
+                             "number",
+                             "integer",
+                             "boolean",
+                             "color",
+                             "list",
+                             "trigger"})
+    {
+        std::string typeName = type;
+        if (typeName == "view_model")
+        {
+            typeName = "viewModel";
+        }
+        propertyType.fields[std::string("is_") + type] = {
+            "$.type == \"" + typeName + "\"",
+            false};
+    }
+    propertyType.fields["backing_name"] = {"$.backingName", false};
+    addCaseExpressions(propertyType, "backing", "$.backingName");
+
+    types["Artboard"].fields = {
+        {"artboard_name", {"$.artboardName", false}},
+        {"artboard_pascal_case", {"$.artboardPascalCase", false}},
+        {"artboard_camel_case", {"$.artboardCameCase", false}},
+        {"artboard_snake_case", {"$.artboardSnakeCase", false}},
+        {"artboard_kebab_case", {"$.artboardKebabCase", false}},
+        {"artboard_index", {"std::to_string($i)", false}},
+        {"animations", {"$.animations", false}},
+        {"state_machines", {"$.stateMachines", false}},
+        {"text_value_runs", {"$.textValueRuns", false}},
+        {"nested_text_value_runs", {"$.nestedTextValueRuns", false}},
+        {"nested_artboards", {"$.nestedArtboards", false}},
+    };
+
+    auto& animation = types["Animation"];
+    animation.uniqueName = "$";
+    animation.fields["animation_name"] = {"$", false};
+    addCaseExpressions(animation, "animation", "$u");
+    animation.fields["animation_index"] = {"std::to_string($i)", false};
+
+    auto& stateMachine = types["StateMachine"];
+    stateMachine.uniqueName = "$.first";
+    stateMachine.fields["state_machine_name"] = {"$.first", false};
+    addCaseExpressions(stateMachine, "state_machine", "$u");
+    stateMachine.fields["state_machine_index"] = {"std::to_string($i)",
+                                                  false};
+    stateMachine.fields["inputs"] = {"$.second", false};
+
+    auto& input = types["Input"];
+    input.uniqueName = "$.name";
+    input.fields["input_name"] = {"$.name", false};
+    addCaseExpressions(input, "input", "$u");
+    input.fields["input_index"] = {"std::to_string($i)", false};
+    input.fields["input_type"] = {"$.type", false};
+    input.fields["input_default_value"] = {"$.defaultValue", false};
+
+    auto& textValueRun = types["TextValueRun"];
+    textValueRun.uniqueName = "$.name";
+    textValueRun.fields["text_value_run_name"] = {"$.name", false};
+    addCaseExpressions(textValueRun, "text_value_run", "$u");
+    textValueRun.fields["text_value_run_default"] = {"$.defaultValue",
+                                                     false};
+    textValueRun.fields["text_value_run_default_sanitized"] = {
+        "sanitizeString($.defaultValue)",
+        false};
+
+    types["NestedTextValueRun"].fields = {
+        {"nested_text_value_run_name", {"$.name", false}},
+        {"nested_text_value_run_path", {"$.path", false}},
+    };
+
+    auto& nestedArtboard = types["NestedArtboard"];
+    nestedArtboard.uniqueName = "$.name";
+    nestedArtboard.fields["nested_artboard_name"] = {"$.name", false};
+    addCaseExpressions(nestedArtboard, "nested_artboard", "$u");
+    nestedArtboard.fields["nested_artboard_artboard_name"] = {
+        "$.artboardName",
+        false};
+    nestedArtboard.fields["nested_artboard_artboard_pascal_case"] = {
+        "toPascalCase($.artboardName)",
+        false};
+    nestedArtboard.fields["nested_artboard_index"] = {
+        "std::to_string($.artboardIndex)",
+        false};
+
+    return types;
+}
+
+// The types of templateDataSchema() with their expressions. Fails if an
+// expression is for a name the schema doesn't have, which would mean the two
+// have drifted apart.
+static bool templateDataTypes(std::map<std::string, Type>& types)
+{
+    auto expressions = templateDataExpressions();
+    for (const auto& schemaType : templateDataSchema())
+    {
+        Type& type = types[schemaType.first];
+        TypeExpressions& typeExpressions = expressions[schemaType.first];
+        type.uniqueName = typeExpressions.uniqueName;
+        for (const auto& schemaField : schemaType.second)
+        {
+            if (schemaField.name == "last")
+            {
+                continue;
+            }
+            Field field{schemaField.name,
+                        schemaField.kind,
+                        "",
+                        schemaField.type};
+            auto expression = typeExpressions.fields.find(schemaField.name);
+            if (expression != typeExpressions.fields.end())
+            {
+                field.expression = expression->second.first;
+                field.shared = expression->second.second;
+                typeExpressions.fields.erase(expression);
+            }
+            type.fields.push_back(field);
+        }
+    }
+
+    for (const auto& typeExpressions : expressions)
+    {
+        for (const auto& field : typeExpressions.second.fields)
+        {
+            std::cerr << "Error: " << typeExpressions.first << " has no \""
+                      << field.first << "\" in the template data schema"
+                      << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::string cppStringLiteral(const std::string& text)
+{
+    static const char* hex = "0123456789abcdef";
+    std::string literal = "\"";
+    for (unsigned char c : text)
+    {
+        switch (c)
+        {
+            case '\\':
+                literal += "\\\\";
+                break;
+            case '"':
+                literal += "\\\"";
+                break;
+            case '\n':
+                literal += "\\n";
+                break;
+            case '\r':
+                literal += "\\r";
+                break;
+            case '\t':
+                literal += "\\t";
+                break;
+            default:
+                if (c < 0x20 || c >= 0x7f)
+                {
+                    // Closing the literal keeps following hex digits from
+                    // extending the escape
+                    literal += "\\x";
+                    literal += hex[c >> 4];
+                    literal += hex[c & 0xf];
+                    literal += "\" \"";
+                }
+                else
+                {
+                    literal += static_cast<char>(c);
+                }
+                break;
+        }
+    }
+    return literal + "\"";
+}
+
+static void replaceAll(std::string& str,
+                       const std::string& from,
+                       const std::string& to)
+{
+    for (size_t i = str.find(from); i != std::string::npos;
+         i = str.find(from, i + to.size()))
+    {
+        str.replace(i, from.size(), to);
+    }
+}
+
+// Emits the body of a render function, tracking at compile time what each
+// level of kainjow's context stack would hold
+class TemplateCodegen
+{
+public:
+    explicit TemplateCodegen(const std::map<std::string, Type>& types) :
+        m_types(types)
+    {
+        Scope root;
+        root.type = &m_types.at("Root");
+        m_scopes.push_back(root);
+    }
+
+    bool generate(const Component& root, std::string& code)
+    {
+        m_indent = 1;
+        if (!emitChildren(root))
+        {
+            return false;
+        }
+        flushText();
+        code = m_code;
+        return true;
+    }
+
+    const std::string& error() const { return m_error; }
+
+private:
+    // What a level of the context stack holds
+    struct Scope
+    {
+        // The type of an item or object, or null for scalars, which names
+        // never resolve in
+        const Type* type = nullptr;
+        std::string item;
+        // The item's unique name, and whether anything used it
+        std::string unique;
+        // The item's index in its list
+        std::string index;
+        bool usesUnique = false;
+        // `last` for list items
+        std::string last;
+        // The value of a section over a string, for {{.}}
+        std::string string;
+    };
+
+    bool emitChildren(const Component& component)
+    {
+        for (const auto& child : component.children)
+        {
+            if (!emit(child))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool emit(const Component& component)
+    {
+        if (component.is_newline())
+        {
+            flushText();
+            line("writer.newline(" + cppStringLiteral(component.text) + ", " +
+                 std::to_string(component.text.size()) + ");");
+            return true;
+        }
+        if (component.is_text())
+        {
+            m_text += component.text;
+            return true;
+        }
+
+        const auto& tag = component.tag;
+        switch (tag.type)
+        {
+            case TagType::variable:
+            case TagType::unescaped_variable:
+                return emitVariable(tag.name,
+                                    tag.type == TagType::variable);
+            case TagType::section_begin:
+            case TagType::section_begin_inverted:
+                return emitSection(component,
+                                   tag.type == TagType::section_begin);
+            case TagType::comment:
+                return true;
+            default:
+                return fail("partials and set delimiters aren't supported");
+        }
+    }
+
+    bool emitVariable(const std::string& name, bool escaped)
+    {
+        std::string value;
+        if (name == ".")
+        {
+            // Only sections over strings push anything {{.}} renders
+            value = m_scopes.back().string;
+        }
+        else
+        {
+            Field field;
+            size_t level = 0;
+            if (!resolve(name, field, level))
+            {
+                return false;
+            }
+            if (field.kind == TemplateFieldKind::String)
+            {
+                value = expand(field.expression, level);
+            }
+        }
+        if (!value.empty())
+        {
+            flushText();
+            line(std::string(escaped ? "writer.escaped(" : "writer.raw(") +
+                 value + ");");
+        }
+        return true;
+    }
+
+    bool emitSection(const Component& component, bool normal)
+    {
+        Field field;
+        size_t level = 0;
+        if (component.tag.name == "." ||
+            !resolve(component.tag.name, field, level))
+        {
+            return m_error.empty() ? fail("sections over {{.}} aren't "
+                                          "supported")
+                                   : false;
+        }
+        std::string value = expand(field.expression, level);
+        flushText();
+
+        if (!normal)
+        {
+            // Only false and empty lists are pushed, and nothing resolves
+            // in them
+            switch (field.kind)
+            {
+                case TemplateFieldKind::Bool:
+                    return emitBody(component, "if (!(" + value + "))", {});
+                case TemplateFieldKind::List:
+                    return emitBody(component,
+                                    "if ((" + value + ").empty())",
+                                    {});
+                default:
+                    // Strings and objects are never falsy
+                    return true;
+            }
+        }
+
+        Scope scope;
+        switch (field.kind)
+        {
+            case TemplateFieldKind::Bool:
+                return emitBody(component, "if (" + value + ")", scope);
+            case TemplateFieldKind::String:
+                scope.string = variable("s");
+                line("{");
+                m_indent++;
+                line("const std::string& " + scope.string + " = " + value +
+                     ";");
+                if (!emitBody(component, "", scope))
+                {
+                    return false;
+                }
+                m_indent--;
+                line("}");
+                return true;
+            case TemplateFieldKind::Object:
+                scope.type = &m_types.at(field.type);
+                scope.item = variable("v");
+                line("{");
+                m_indent++;
+                line("const auto& " + scope.item + " = " + value + ";");
+                if (!emitBody(component, "", scope))
+                {
+                    return false;
+                }
+                m_indent--;
+                line("}");
+                return true;
+            case TemplateFieldKind::List:
+                return emitList(component, field, value);
+        }
+        return true;
+    }
+
+    // A section body rendered once if `condition` holds
+    bool emitBody(const Component& component,
+                  const std::string& condition,
+                  const Scope& scope)
+    {
+        if (!condition.empty())
+        {
+            line(condition);
+        }
+        line("{");
+        m_indent++;
+        line("writer.section();");
+        m_scopes.push_back(scope);
+        if (!emitChildren(component))
+        {
+            return false;
+        }
+        flushText();
+        m_scopes.pop_back();
+        line("writer.section();");
+        m_indent--;
+        line("}");
+        return true;
+    }
+
+    bool emitList(const Component& component,
+                  const Field& field,
+                  const std::string& value)
+    {
+        const Type& type = m_types.at(field.type);
+        std::string list = variable("c");
+        std::string index = variable("i");
+        std::string used = variable("used");
+
+        Scope scope;
+        scope.type = &type;
+        scope.item = variable("v");
+        scope.unique = variable("u");
+        scope.index = index;
+        scope.last = index + " + 1 == " + list + ".size()";
+
+        // The body goes first, to know whether it needs unique names
+        std::string outer;
+        std::swap(outer, m_code);
+        int outerIndent = m_indent;
+        m_indent = 0;
+        m_scopes.push_back(scope);
+        if (!emitChildren(component))
+        {
+            return false;
+        }
+        flushText();
+        bool usesUnique = m_scopes.back().usesUnique;
+        m_scopes.pop_back();
+        line("writer.section();");
+        std::string body;
+        std::swap(body, m_code);
+        std::swap(outer, m_code);
+        m_indent = outerIndent;
+
+        line("{");
+        m_indent++;
+        line("const auto& " + list + " = " + value + ";");
+        line("if (!" + list + ".empty())");
+        line("{");
+        m_indent++;
+        line("writer.section();");
+        if (usesUnique)
+        {
+            line("std::unordered_set<std::string> " + used + ";");
+        }
+        line("for (size_t " + index + " = 0; " + index + " < " + list +
+             ".size(); " + index + "++)");
+        line("{");
+        m_indent++;
+        line("const auto& " + scope.item + " = " +
+             (field.shared ? "*" : "") + list + "[" + index + "];");
+        if (usesUnique)
+        {
+            std::string uniqueName = type.uniqueName;
+            replaceAll(uniqueName, "$", scope.item);
+            line("std::string " + scope.unique + " = makeUnique(" +
+                 uniqueName + ", " + used + ");");
+        }
+        // Re-indent the body under the loop
+        std::string prefix(m_indent * 4, ' ');
+        size_t start = 0;
+        while (start < body.size())
+        {
+            size_t end = body.find('\n', start);
+            m_code += prefix + body.substr(start, end - start + 1);
+            start = end + 1;
+        }
+        m_indent--;
+        line("}");
+        m_indent--;
+        line("}");
+        m_indent--;
+        line("}");
+        return true;
+    }
+
+    // Finds `name` in the topmost level that defines it, like kainjow
+    bool resolve(const std::string& name, Field& field, size_t& level)
+    {
+        if (name.find('.') != std::string::npos)
+        {
+            return fail("dotted name \"" + name + "\" isn't supported");
+        }
+        for (level = m_scopes.size(); level-- > 0;)
+        {
+            const Scope& scope = m_scopes[level];
+            if (scope.type == nullptr)
+            {
+                continue;
+            }
+            if (name == "last" && !scope.last.empty())
+            {
+                field = {name, TemplateFieldKind::Bool, scope.last};
+                return true;
+            }
+            for (const auto& candidate : scope.type->fields)
+            {
+                if (candidate.name == name)
+                {
+                    if (candidate.expression.empty())
+                    {
+                        return fail("\"" + name +
+                                    "\" isn't supported in built-in "
+                                    "templates");
+                    }
+                    field = candidate;
+                    return true;
+                }
+            }
+        }
+        return fail("\"" + name + "\" isn't in the template data here");
+    }
+
+    std::string expand(std::string expression, size_t level)
+    {
+        Scope& scope = m_scopes[level];
+        if (expression.find("$u") != std::string::npos)
+        {
+            scope.usesUnique = true;
+            replaceAll(expression, "$u", scope.unique);
+        }
+        replaceAll(expression, "$i", scope.index);
+        replaceAll(expression, "$", scope.item);
+        return expression;
+    }
+
+    std::string variable(const char* prefix)
+    {
+        return prefix + std::to_string(m_nextVariable++);
+    }
+
+    void flushText()
+    {
+        if (!m_text.empty())
+        {
+            line("writer.text(" + cppStringLiteral(m_text) + ", " +
+                 std::to_string(m_text.size()) + ");");
+            m_text.clear();
+        }
+    }
+
+    void line(const std::string& code)
+    {
+        m_code += std::string(m_indent * 4, ' ') + code + "\n";
+    }
+
+    bool fail(const std::string& error)
+    {
+        m_error = error;
+        return false;
+    }
+
+    const std::map<std::string, Type>& m_types;
+    std::vector<Scope> m_scopes;
+    std::string m_code;
+    std::string m_text;
+    std::string m_error;
+    int m_indent = 0;
+    int m_nextVariable = 0;
+};
+
+struct BuiltInTemplate
+{
+    const char* source;
+    const char* function;
+};
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <output.cpp>" << std::endl;
+        return 1;
+    }
+
+    const BuiltInTemplate builtInTemplates[] = {
+        {default_templates::DEFAULT_DART_TEMPLATE, "renderDefaultDartTemplate"},
+    };
+
+    std::map<std::string, Type> types;
+    if (!templateDataTypes(types))
+    {
+        return 1;
+    }
+    std::string code =
+        "// Generated from include/default_template.h by "
+        "tools/template_codegen.cpp\n"
+        "\n"
+        "#include <unordered_set>\n"
+        "\n"
+        "#include \"builtin_templates.h\"\n"
+        "#include \"naming.h\"\n"
+        "#include \"string_escape.h\"\n"
+        "#include \"template_data.h\"\n"
+        "#include \"template_writer.h\"\n";
+    for (const auto& builtIn : builtInTemplates)
+    {
+        kainjow::mustache::context<std::string> context;
+        kainjow::mustache::context_internal<std::string> parseContext{
+            context};
+        Component root;
+        std::string error;
+        kainjow::mustache::parser<std::string> parser{builtIn.source,
+                                                      parseContext,
+                                                      root,
+                                                      error};
+        std::string body;
+        TemplateCodegen codegen(types);
+        if (error.empty() && !codegen.generate(root, body))
+        {
+            error = codegen.error();
+        }
+        if (!error.empty())
+        {
+            std::cerr << "Error: Can't compile " << builtIn.function << ": "
+                      << error << std::endl;
+            return 1;
+        }
+
+        std::string function = "void " + std::string(builtIn.function) + "(";
+        std::string indent(function.size(), ' ');
+        code += "\n" + function + "const std::vector<RiveFileData>& files,\n" +
+                indent + "const std::string& generatedFileName,\n" + indent +
+                "std::string& output)\n"
+                "{\n"
+                "    TemplateWriter writer(output);\n" +
+                body +
+                "    writer.finish();\n"
+                "}\n";
+    }
+
+    std::ofstream output(argv[1], std::ios::binary | std::ios::trunc);
+    output << code;
+    output.close();
+    if (!output)
+    {
+        std::cerr << "Error: Failed to write output file: " << argv[1]
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}